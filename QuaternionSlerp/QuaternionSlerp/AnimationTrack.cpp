@@ -0,0 +1,196 @@
+/*
+Title: Quaternion Math
+File Name: AnimationTrack.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "AnimationTrack.h"
+#include "QuaternionBatch.h"
+
+#include <algorithm>
+
+// Up to this many keys, counting every time is faster than a binary search, whose branches are unpredictable
+static const int LINEAR_SEARCH_KEYS = 64;
+
+// Samples are interpolated in blocks of this many by Evaluate
+static const int TRACK_BLOCK = 64;
+
+void RotationTrack::AddKey(float time, Quaternion q)
+{
+	if (!keys.empty() && Dot(keys.back(), q) < 0)
+	{
+		q = -q;
+	}
+
+	times.push_back(time);
+	keys.push_back(q);
+}
+
+// The searches are written once for any type of time, for the float times of RotationTrack
+//  and the 16-bit ticks of CompressedRotationTrack
+template <typename Time>
+static int FindSegmentIn(const Time* times, int count, float t)
+{
+	int last = (count > 1) ? count - 2 : 0;
+	int after;
+
+	if (count <= LINEAR_SEARCH_KEYS)
+	{
+		after = 0;
+		for (int i = 0; i < count; i++)
+		{
+			after += (times[i] <= t);
+		}
+	}
+	else
+	{
+		after = (int)(std::upper_bound(times, times + count, t) - times);
+	}
+
+	// after is the number of keys at or before t, so t is in the segment starting at the last of them
+	int segment = after - 1;
+	return (segment < 0) ? 0 : (segment > last) ? last : segment;
+}
+
+template <typename Time>
+static int FindSegmentIn(const Time* times, int count, float t, TrackCursor& cursor)
+{
+	int s = cursor.segment;
+
+	if (s + 1 < count && times[s] <= t)
+	{
+		if (t < times[s + 1])
+		{
+			return s;
+		}
+
+		// Moved into the next segment, or past the end of the track
+		if (s + 2 >= count || t < times[s + 2])
+		{
+			cursor.segment = (s + 2 < count) ? s + 1 : s;
+			return cursor.segment;
+		}
+	}
+
+	cursor.segment = FindSegmentIn(times, count, t);
+	return cursor.segment;
+}
+
+template <typename Time>
+static float SegmentFractionIn(const Time* times, int count, int segment, float t)
+{
+	if (segment + 1 >= count)
+	{
+		return 0;
+	}
+
+	float u = (t - times[segment]) / ((float)times[segment + 1] - times[segment]);
+	return (u < 0) ? 0 : (u > 1) ? 1 : u;
+}
+
+int FindSegment(const float* times, int count, float t)
+{
+	return FindSegmentIn(times, count, t);
+}
+
+int FindSegment(const float* times, int count, float t, TrackCursor& cursor)
+{
+	return FindSegmentIn(times, count, t, cursor);
+}
+
+float SegmentFraction(const float* times, int count, int segment, float t)
+{
+	return SegmentFractionIn(times, count, segment, t);
+}
+
+int FindSegment(const uint16_t* ticks, int count, float t)
+{
+	return FindSegmentIn(ticks, count, t);
+}
+
+int FindSegment(const uint16_t* ticks, int count, float t, TrackCursor& cursor)
+{
+	return FindSegmentIn(ticks, count, t, cursor);
+}
+
+float SegmentFraction(const uint16_t* ticks, int count, int segment, float t)
+{
+	return SegmentFractionIn(ticks, count, segment, t);
+}
+
+int RotationTrack::FindSegment(float t) const
+{
+	return ::FindSegment(times.data(), (int)times.size(), t);
+}
+
+int RotationTrack::FindSegment(float t, TrackCursor& cursor) const
+{
+	return ::FindSegment(times.data(), (int)times.size(), t, cursor);
+}
+
+Quaternion RotationTrack::Evaluate(float t) const
+{
+	TrackCursor cursor;
+	return Evaluate(t, cursor);
+}
+
+Quaternion RotationTrack::Evaluate(float t, TrackCursor& cursor) const
+{
+	int segment = FindSegment(t, cursor);
+
+	// Holding the first or last key needs no interpolation
+	if (t <= times[segment])
+	{
+		return keys[segment];
+	}
+	if (segment + 1 >= (int)keys.size() || t >= times[segment + 1])
+	{
+		return keys[(segment + 1 < (int)keys.size()) ? segment + 1 : segment];
+	}
+
+	return Slerp(keys[segment], keys[segment + 1], SegmentFraction(times.data(), (int)times.size(), segment, t));
+}
+
+void RotationTrack::Evaluate(const float* t, Quaternion* out, int count) const
+{
+	float aw[TRACK_BLOCK], ax[TRACK_BLOCK], ay[TRACK_BLOCK], az[TRACK_BLOCK];
+	float bw[TRACK_BLOCK], bx[TRACK_BLOCK], by[TRACK_BLOCK], bz[TRACK_BLOCK];
+	float ow[TRACK_BLOCK], ox[TRACK_BLOCK], oy[TRACK_BLOCK], oz[TRACK_BLOCK];
+	float u[TRACK_BLOCK];
+	QuaternionSoA a = { aw, ax, ay, az };
+	QuaternionSoA b = { bw, bx, by, bz };
+	QuaternionSoA o = { ow, ox, oy, oz };
+	TrackCursor cursor;
+	int last = (int)keys.size() - 1;
+
+	for (int start = 0; start < count; start += TRACK_BLOCK)
+	{
+		int n = (count - start < TRACK_BLOCK) ? count - start : TRACK_BLOCK;
+
+		for (int i = 0; i < n; i++)
+		{
+			int segment = FindSegment(t[start + i], cursor);
+			int next = (segment < last) ? segment + 1 : segment;
+			Quaternion qa = keys[segment], qb = keys[next];
+
+			aw[i] = qa.w; ax[i] = qa.x; ay[i] = qa.y; az[i] = qa.z;
+			bw[i] = qb.w; bx[i] = qb.x; by[i] = qb.y; bz[i] = qb.z;
+			u[i] = SegmentFraction(times.data(), (int)times.size(), segment, t[start + i]);
+		}
+
+		SlerpBatch(a, b, u, o, n);
+		FromSoA(o, out + start, n);
+	}
+}
@@ -0,0 +1,82 @@
+/*
+Title: Quaternion Math
+File Name: AnimationTrack.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "Quaternion.h"
+
+#include <cstdint>
+#include <vector>
+
+// Remembers which pair of keys a track was last sampled between, so that playing forward through time
+//  finds the next pair without searching. Keep one cursor per playing instance of a track.
+struct TrackCursor
+{
+	int segment;
+
+	TrackCursor() : segment(0) {}
+};
+
+// Returns the segment of a sorted array of count key times that time t falls in: the index i of the keys i and i + 1
+//  with times[i] <= t < times[i + 1], clamped to the first and last segments. With a single key it is segment 0.
+// Short arrays are searched by counting the times up to t, a loop without branches that is vectorized,
+//  and longer ones by binary search.
+int FindSegment(const float* times, int count, float t);
+// The same, starting from the cursor's segment. Checking it and the one after it first makes playing forward
+//  cost O(1) per sample; other jumps, such as looping or seeking, fall back to searching. Updates the cursor.
+int FindSegment(const float* times, int count, float t, TrackCursor& cursor);
+// Returns how far t is through the segment, from 0 at its first key to 1 at its second, clamped to [0, 1].
+float SegmentFraction(const float* times, int count, int segment, float t);
+// The same three over key times stored as 16-bit ticks, with t given in ticks
+int FindSegment(const uint16_t* ticks, int count, float t);
+int FindSegment(const uint16_t* ticks, int count, float t, TrackCursor& cursor);
+float SegmentFraction(const uint16_t* ticks, int count, int segment, float t);
+
+// A rotation that changes over time, given by keys at increasing times and interpolated with Slerp in between.
+// The times are kept in their own array, apart from the quaternions, so a search only touches the times.
+// Before the first key and after the last the track holds the first or last key.
+struct RotationTrack
+{
+	std::vector<float> times;
+	std::vector<Quaternion> keys;
+
+	// Adds a key at the end of the track. time must be greater than the time of the last key.
+	// Slerp follows the arc between two quaternions as given, and q and -q are the same rotation,
+	//  so q is flipped if needed to be on the same side as the previous key, to take the shorter way around.
+	void AddKey(float time, Quaternion q);
+
+	// The segment of the track that time t falls in, as with the FindSegment functions above
+	int FindSegment(float t) const;
+	int FindSegment(float t, TrackCursor& cursor) const;
+
+	// Returns the rotation at time t. The track must have at least one key.
+	Quaternion Evaluate(float t) const;
+	Quaternion Evaluate(float t, TrackCursor& cursor) const;
+
+	// Samples the track at count times: out[i] = Evaluate(t[i]).
+	// The keys are found with one cursor, so sorted times are fastest, and the interpolation is done with SlerpBatch.
+	void Evaluate(const float* t, Quaternion* out, int count) const;
+};
+
+// The animation of a whole skeleton: a rotation track for each joint, and the joint's translation from its parent,
+//  which stays the same for the whole clip. Both are in the joint order of the skeleton the clip is made for.
+struct AnimationClip
+{
+	std::vector<RotationTrack> rotations;
+	std::vector<Vector3D> translations;
+};
@@ -0,0 +1,1114 @@
+/*
+Title: Quaternion Math
+File Name: Benchmarks.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Times every public function of Quaternion.h, Vector2D/3D/4D.h and Matrix2D/3D/4D.h,
+//  and the batch and pipeline functions built on them: QuaternionBatch.h, MatrixBatch.h, SkinVertices,
+//  ComputeWorldTransforms, PoseEvaluator and the stream mode of QuaternionStream.h.
+//
+//  QuaternionBenchmarks [--filter text] [--sizes L1,L2,L3,DRAM] [--time ms]
+//                       [--json out.json] [--baseline old.json] [--threshold 0.1]
+//
+// Each benchmark calls one function over arrays of random inputs, writing the results to an output array,
+//  at four working set sizes (inputs plus outputs) chosen to fit in the L1, L2 and L3 caches of most CPUs and
+//  to not fit in any of them (DRAM). A measurement repeats passes over the arrays for at least --time milliseconds,
+//  and the fastest of three measurements is reported, as nanoseconds and time stamp counter cycles per call
+//  (the TSC counts at a fixed rate, so it is only the core's clock when the core runs at its base frequency),
+//  and calls per second.
+// The batch and pipeline functions work on whole arrays, so they are timed a whole pass over their arrays at a time,
+//  and reported per element (a quaternion, vector, matrix, vertex, joint or stream record), to compare with the scalar
+//  function each one stands in for. The stream mode reads and writes temporary files, so it includes the file I/O.
+// --json writes the results, one per line. --baseline reads results written that way, and lists every benchmark
+//  that got slower by more than --threshold (a fraction, 0.1 for 10%), in which case the program returns 1.
+// It also lists the benchmarks that are only in one of the two runs: new ones that aren't in the baseline, and
+//  ones in the baseline (that --filter and --sizes select) which no longer exist. Missing ones also return 1,
+//  since a renamed or removed benchmark would otherwise drop out of the comparison unnoticed.
+#include "Matrix2D.h"
+#include "Matrix3D.h"
+#include "Matrix4D.h"
+#include "MatrixBatch.h"
+#include "PoseEvaluator.h"
+#include "Quaternion.h"
+#include "QuaternionBatch.h"
+#include "QuaternionStream.h"
+#include "Skeleton.h"
+#include "Skinning.h"
+#include "Vector2D.h"
+#include "Vector3D.h"
+#include "Vector4D.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define HAVE_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+static uint64_t ReadTsc()
+{
+#if HAVE_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+struct CacheSize
+{
+	const char* name;
+	size_t bytes;
+};
+
+static const CacheSize SIZES[] = { { "L1", 16 << 10 }, { "L2", 128 << 10 }, { "L3", 4 << 20 }, { "DRAM", 64 << 20 } };
+
+// A small fast generator for the inputs (xorshift64*), seeded the same every time so runs see the same data
+struct Random
+{
+	uint64_t state;
+
+	Random() : state(0x9E3779B97F4A7C15ull) {}
+
+	float Uniform(float lo, float hi)
+	{
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		uint32_t bits = (uint32_t)((state * 0x2545F4914F6CDD1Dull) >> 40);
+		return lo + (hi - lo) * (float)bits * (1.0f / 16777216.0f);
+	}
+};
+
+// The kinds of input, each made up from random numbers.
+// Matrices have 2 added along the diagonal so that they are never close to singular.
+static float AnyFloat(Random& r) { return r.Uniform(-10, 10); }
+static float Positive(Random& r) { return r.Uniform(0.5f, 2); }
+static float Fraction(Random& r) { return r.Uniform(0, 1); }
+static float Angle(Random& r) { return r.Uniform(-3.14159265f, 3.14159265f); }
+static int Index2(Random& r) { return (int)r.Uniform(0, 1.99f); }
+static int Index3(Random& r) { return (int)r.Uniform(0, 2.99f); }
+static int Index4(Random& r) { return (int)r.Uniform(0, 3.99f); }
+static Vector2D AnyVector2(Random& r) { return Vector2D(AnyFloat(r), AnyFloat(r)); }
+static Vector3D AnyVector3(Random& r) { return Vector3D(AnyFloat(r), AnyFloat(r), AnyFloat(r)); }
+static Vector4D AnyVector4(Random& r) { return Vector4D(AnyFloat(r), AnyFloat(r), AnyFloat(r), AnyFloat(r)); }
+static Vector3D UnitVector3(Random& r) { return Normalize(Vector3D(AnyFloat(r), AnyFloat(r), AnyFloat(r)) + Vector3D(0, 0, 0.01f)); }
+static Quaternion AnyQuaternion(Random& r) { return Quaternion(AnyFloat(r), AnyFloat(r), AnyFloat(r), AnyFloat(r)); }
+static Quaternion UnitQuaternion(Random& r) { return Rotation(UnitVector3(r), Angle(r)); }
+static double AnyDouble(Random& r) { return AnyFloat(r); }
+static double PositiveDouble(Random& r) { return Positive(r); }
+static double FractionDouble(Random& r) { return Fraction(r); }
+static QuaternionD AnyQuaternionD(Random& r) { return QuaternionD(AnyQuaternion(r)); }
+static QuaternionD UnitQuaternionD(Random& r) { return Normalize(QuaternionD(UnitQuaternion(r))); }
+static Matrix2D AnyMatrix2(Random& r) { return Matrix2D(r.Uniform(-1, 1) + 2, r.Uniform(-1, 1), r.Uniform(-1, 1), r.Uniform(-1, 1) + 2); }
+static Matrix3D AnyMatrix3(Random& r) { return Matrix3D(AnyVector3(r) / 10 + Vector3D(2, 0, 0), AnyVector3(r) / 10 + Vector3D(0, 2, 0), AnyVector3(r) / 10 + Vector3D(0, 0, 2)); }
+static Matrix3D RotationMatrix3(Random& r) { return RotationMatrix(UnitQuaternion(r)); }
+static Matrix4D AnyMatrix4(Random& r)
+{
+	return Matrix4D(AnyVector4(r) / 10 + Vector4D(2, 0, 0, 0), AnyVector4(r) / 10 + Vector4D(0, 2, 0, 0),
+		AnyVector4(r) / 10 + Vector4D(0, 0, 2, 0), AnyVector4(r) / 10 + Vector4D(0, 0, 0, 2));
+}
+static Matrix4D AffineMatrix4(Random& r)
+{
+	Matrix3D a = AnyMatrix3(r);
+	return Matrix4D(Vector4D(a[0], 0), Vector4D(a[1], 0), Vector4D(a[2], 0), Vector4D(AnyVector3(r), 1));
+}
+static Matrix4D RigidMatrix4(Random& r)
+{
+	Matrix3D a = RotationMatrix3(r);
+	return Matrix4D(Vector4D(a[0], 0), Vector4D(a[1], 0), Vector4D(a[2], 0), Vector4D(AnyVector3(r), 1));
+}
+
+// A stream that formats everything written to it and then throws it away, for timing operator<<
+class NullBuffer : public std::streambuf
+{
+protected:
+	int overflow(int c) override { return c; }
+	std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+static NullBuffer nullBuffer;
+static std::ostream nullStream(&nullBuffer);
+
+struct Result
+{
+	std::string name;
+	std::string size;
+	size_t bytes;
+	double nsPerOp;
+	double opsPerSecond;
+	double tscPerOp;
+};
+
+struct Benchmark
+{
+	std::string name;
+	// Measures one working set size, giving the fastest ns and TSC cycles per call
+	std::function<void(size_t bytes, double minSeconds, double& ns, double& tsc)> measure;
+};
+
+static std::vector<Benchmark> benchmarks;
+
+// Read after each measurement, so that the compiler can't drop the calls being timed
+static volatile unsigned char sink;
+
+template <typename T>
+static void Consume(const std::vector<T>& out)
+{
+	const unsigned char* bytes = (const unsigned char*)out.data();
+	unsigned char sum = 0;
+	for (size_t i = 0; i < out.size() * sizeof(T); i += 64)
+	{
+		sum = (unsigned char)(sum + bytes[i]);
+	}
+	sink = (unsigned char)(sink + sum);
+}
+
+// The type a generator makes, and the type a function returns for those inputs.
+// bool results are stored as unsigned char, since std::vector<bool> packs them into bits.
+template <typename G>
+using InputOf = decltype(std::declval<G&>()(std::declval<Random&>()));
+
+template <typename F, typename... Gens>
+using OutputOf = typename std::conditional<std::is_same<decltype(std::declval<F&>()(std::declval<InputOf<Gens>>()...)), bool>::value,
+	unsigned char, decltype(std::declval<F&>()(std::declval<InputOf<Gens>>()...))>::type;
+
+// Making the inputs takes longer than timing the function, so the largest arrays repeat the first
+//  INPUT_PERIOD inputs, which is still far too many for the branch predictor to learn.
+static const size_t INPUT_PERIOD = 1 << 16;
+
+template <typename T, typename G>
+static int Fill(std::vector<T>& v, G& gen, Random& random, size_t n)
+{
+	v.resize(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		v[i] = (i < INPUT_PERIOD) ? gen(random) : v[i - INPUT_PERIOD];
+	}
+	return 0;
+}
+
+static size_t Sum()
+{
+	return 0;
+}
+
+template <typename... Sizes>
+static size_t Sum(size_t first, Sizes... rest)
+{
+	return first + Sum(rest...);
+}
+
+// Times out[i] = f(inputs0[i], inputs1[i], ...) over as many elements as fit in bytes,
+//  with argument k of every call made by generator k.
+template <typename F, typename... Gens, size_t... I>
+static void Measure(F& f, std::tuple<Gens...>& gens, std::index_sequence<I...>, size_t bytes, double minSeconds,
+	double& ns, double& tsc)
+{
+	typedef OutputOf<F, Gens...> Output;
+	size_t perCall = sizeof(Output) + Sum(sizeof(InputOf<Gens>)...);
+	size_t n = (bytes / perCall > 0) ? bytes / perCall : 1;
+
+	Random random;
+	std::tuple<std::vector<InputOf<Gens>>...> inputs;
+	int filled[] = { 0, Fill(std::get<I>(inputs), std::get<I>(gens), random, n)... };
+	(void)filled;
+	std::vector<Output> out(n);
+
+	ns = 1e300;
+	tsc = 1e300;
+	for (int trial = 0; trial < 3; trial++)
+	{
+		long long calls = 0;
+		double elapsed;
+		auto start = std::chrono::steady_clock::now();
+		uint64_t tscStart = ReadTsc();
+
+		do
+		{
+			for (size_t i = 0; i < n; i++)
+			{
+				out[i] = (Output)f(std::get<I>(inputs)[i]...);
+			}
+			calls += (long long)n;
+			elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		} while (elapsed < minSeconds);
+
+		uint64_t tscEnd = ReadTsc();
+		Consume(out);
+
+		ns = std::fmin(ns, elapsed * 1e9 / (double)calls);
+		tsc = std::fmin(tsc, (double)(tscEnd - tscStart) / (double)calls);
+	}
+}
+
+// Adds a benchmark of f, called with one argument made by each of gens
+template <typename F, typename... Gens>
+static void Add(const char* name, F f, Gens... gens)
+{
+	std::tuple<Gens...> generators(gens...);
+
+	Benchmark b;
+	b.name = name;
+	b.measure = [f, generators](size_t bytes, double minSeconds, double& ns, double& tsc) mutable
+	{
+		Measure(f, generators, std::index_sequence_for<Gens...>(), bytes, minSeconds, ns, tsc);
+	};
+	benchmarks.push_back(b);
+}
+
+// A pass runs a batch function over all of its arrays once and returns the number of elements it did
+typedef std::function<size_t()> Pass;
+
+// Times passes, as Measure times calls, giving the fastest ns and TSC cycles per element
+static void MeasurePasses(Pass& pass, double minSeconds, double& ns, double& tsc)
+{
+	ns = 1e300;
+	tsc = 1e300;
+	for (int trial = 0; trial < 3; trial++)
+	{
+		long long elements = 0;
+		double elapsed;
+		auto start = std::chrono::steady_clock::now();
+		uint64_t tscStart = ReadTsc();
+
+		do
+		{
+			elements += (long long)pass();
+			elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		} while (elapsed < minSeconds);
+
+		uint64_t tscEnd = ReadTsc();
+
+		ns = std::fmin(ns, elapsed * 1e9 / (double)elements);
+		tsc = std::fmin(tsc, (double)(tscEnd - tscStart) / (double)elements);
+	}
+}
+
+// Adds a benchmark of a batch function. setup(bytes) makes the data for a working set of about bytes,
+//  and returns the pass that is timed. The batch functions are compiled in their own files and write their results
+//  to memory, so unlike the calls that Measure times, the compiler can't drop them.
+template <typename Setup>
+static void AddBatch(const char* name, Setup setup)
+{
+	Benchmark b;
+	b.name = name;
+	b.measure = [setup](size_t bytes, double minSeconds, double& ns, double& tsc)
+	{
+		Pass pass = setup(bytes);
+		MeasurePasses(pass, minSeconds, ns, tsc);
+	};
+	benchmarks.push_back(b);
+}
+
+// The number of elements of perElement bytes each that fit in bytes, at least 1
+static size_t Elements(size_t bytes, size_t perElement)
+{
+	return (bytes / perElement > 0) ? bytes / perElement : 1;
+}
+
+// n inputs made by gen, repeating after INPUT_PERIOD as Measure's do
+template <typename G>
+static std::vector<InputOf<G>> Inputs(G gen, Random& random, size_t n)
+{
+	std::vector<InputOf<G>> v;
+	Fill(v, gen, random, n);
+	return v;
+}
+
+// The template functions of Quaternion.h, which are timed for both Quaternion and QuaternionD
+template <typename T>
+static void AddQuaternionBenchmarks(const char* type, T (*anyScalar)(Random&), T (*positive)(Random&), T (*fraction)(Random&),
+	QuaternionT<T> (*any)(Random&), QuaternionT<T> (*unit)(Random&))
+{
+	typedef QuaternionT<T> Q;
+	std::string t = type;
+	Add((t + "/operator+").c_str(), [](Q q, Q r) { return q + r; }, any, any);
+	Add((t + "/operator-(q)").c_str(), [](Q q) { return -q; }, any);
+	Add((t + "/operator-").c_str(), [](Q q, Q r) { return q - r; }, any, any);
+	Add((t + "/operator*").c_str(), [](Q q, Q r) { return q * r; }, any, any);
+	Add((t + "/operator*(s,q)").c_str(), [](T s, Q q) { return s * q; }, anyScalar, any);
+	Add((t + "/operator*(q,s)").c_str(), [](Q q, T s) { return q * s; }, any, anyScalar);
+	Add((t + "/Norm").c_str(), [](Q q) { return Norm(q); }, any);
+	Add((t + "/Magnitude").c_str(), [](Q q) { return Magnitude(q); }, any);
+	Add((t + "/operator/(q,s)").c_str(), [](Q q, T s) { return q / s; }, any, positive);
+	Add((t + "/operator/").c_str(), [](Q q, Q r) { return q / r; }, any, any);
+	Add((t + "/Normalize").c_str(), [](Q q) { return Normalize(q); }, any);
+	Add((t + "/Conjugate").c_str(), [](Q q) { return Conjugate(q); }, any);
+	Add((t + "/Inverse").c_str(), [](Q q) { return Inverse(q); }, any);
+	Add((t + "/Dot").c_str(), [](Q q, Q r) { return Dot(q, r); }, any, any);
+	Add((t + "/AngleBetweenQuaternions").c_str(), [](Q q, Q r) { return AngleBetweenQuaternions(q, r); }, unit, unit);
+	Add((t + "/Slerp").c_str(), [](Q a, Q b, T u) { return Slerp(a, b, u); }, unit, unit, fraction);
+	Add((t + "/Slerp<SlerpExact>").c_str(), [](Q a, Q b, T u) { return Slerp<SlerpExact>(a, b, u); }, unit, unit, fraction);
+	Add((t + "/Slerp<SlerpPolynomial>").c_str(), [](Q a, Q b, T u) { return Slerp<SlerpPolynomial>(a, b, u); }, unit, unit, fraction);
+	Add((t + "/Slerp<SlerpCorrectedNlerp>").c_str(), [](Q a, Q b, T u) { return Slerp<SlerpCorrectedNlerp>(a, b, u); },
+		unit, unit, fraction);
+	Add((t + "/RotationMatrix").c_str(), [](Q q) { return RotationMatrix(q); }, unit);
+	Add((t + "/RotateVector").c_str(), [](Vector3D v, Q q) { return RotateVector(v, q); }, AnyVector3, unit);
+	Add((t + "/operator<<").c_str(), [](Q q) { return (bool)(nullStream << q); }, any);
+}
+
+// The functions that Vector2D, Vector3D and Vector4D all have
+template <typename V>
+static void AddVectorBenchmarks(const char* type, V (*any)(Random&))
+{
+	std::string t = type;
+	Add((t + "/operator-(v)").c_str(), [](V v) { return -v; }, any);
+	Add((t + "/operator+").c_str(), [](V l, V r) { return l + r; }, any, any);
+	Add((t + "/operator-").c_str(), [](V l, V r) { return l - r; }, any, any);
+	Add((t + "/operator*(s,v)").c_str(), [](float s, V v) { return s * v; }, AnyFloat, any);
+	Add((t + "/operator*(v,s)").c_str(), [](V v, float s) { return v * s; }, any, AnyFloat);
+	Add((t + "/operator/").c_str(), [](V v, float s) { return v / s; }, any, Positive);
+	Add((t + "/operator==").c_str(), [](V l, V r) { return l == r; }, any, any);
+	Add((t + "/operator!=").c_str(), [](V l, V r) { return l != r; }, any, any);
+	Add((t + "/Dot").c_str(), [](V l, V r) { return Dot(l, r); }, any, any);
+	Add((t + "/Project").c_str(), [](V a, V b) { return Project(a, b); }, any, any);
+	Add((t + "/Reject").c_str(), [](V a, V b) { return Reject(a, b); }, any, any);
+	Add((t + "/Normalize").c_str(), [](V v) { return Normalize(v); }, any);
+	Add((t + "/Magnitude").c_str(), [](V v) { return Magnitude(v); }, any);
+	Add((t + "/MagInverse").c_str(), [](V v) { return MagInverse(v); }, any);
+	Add((t + "/MagFastInv").c_str(), [](V v) { return MagFastInv(v); }, any);
+	Add((t + "/MagSquared").c_str(), [](V v) { return MagSquared(v); }, any);
+	Add((t + "/operator<<").c_str(), [](V v) { return (bool)(nullStream << v); }, any);
+}
+
+// The functions that Matrix2D, Matrix3D and Matrix4D all have. index makes the i and j of Minor and Cofactor.
+template <typename M, typename V>
+static void AddMatrixBenchmarks(const char* type, M (*any)(Random&), V (*anyVector)(Random&), int (*index)(Random&))
+{
+	std::string t = type;
+	Add((t + "/operator()").c_str(), [](const M& m, int i, int j) { return m(i, j); }, any, index, index);
+	Add((t + "/row").c_str(), [](const M& m, int i) { return m.row(i); }, any, index);
+	Add((t + "/col").c_str(), [](const M& m, int j) { return m.col(j); }, any, index);
+	Add((t + "/operator-(m)").c_str(), [](const M& m) { return -m; }, any);
+	Add((t + "/operator*(s,m)").c_str(), [](float s, const M& m) { return s * m; }, AnyFloat, any);
+	Add((t + "/operator*(m,s)").c_str(), [](const M& m, float s) { return m * s; }, any, AnyFloat);
+	Add((t + "/operator/").c_str(), [](const M& m, float s) { return m / s; }, any, Positive);
+	Add((t + "/operator+").c_str(), [](const M& l, const M& r) { return l + r; }, any, any);
+	Add((t + "/operator-").c_str(), [](const M& l, const M& r) { return l - r; }, any, any);
+	Add((t + "/operator*").c_str(), [](const M& l, const M& r) { return l * r; }, any, any);
+	Add((t + "/operator*(m,v)").c_str(), [](const M& m, V v) { return m * v; }, any, anyVector);
+	Add((t + "/operator*(v,m)").c_str(), [](V v, const M& m) { return v * m; }, anyVector, any);
+	Add((t + "/operator==").c_str(), [](const M& l, const M& r) { return l == r; }, any, any);
+	Add((t + "/operator!=").c_str(), [](const M& l, const M& r) { return l != r; }, any, any);
+	Add((t + "/Determinant").c_str(), [](const M& m) { return Determinant(m); }, any);
+	Add((t + "/Inverse").c_str(), [](const M& m) { return Inverse(m); }, any);
+	Add((t + "/InverseAdj").c_str(), [](const M& m) { return InverseAdj(m); }, any);
+	Add((t + "/Minor").c_str(), [](const M& m, int i, int j) { return Minor(m, i, j); }, any, index, index);
+	Add((t + "/Cofactor").c_str(), [](const M& m, int i, int j) { return Cofactor(m, i, j); }, any, index, index);
+	Add((t + "/CofactorMatrix").c_str(), [](const M& m) { return CofactorMatrix(m); }, any);
+	Add((t + "/Adjugate").c_str(), [](const M& m) { return Adjugate(m); }, any);
+	Add((t + "/Transpose").c_str(), [](const M& m) { return Transpose(m); }, any);
+	Add((t + "/Outer").c_str(), [](V a, V b) { return Outer(a, b); }, anyVector, anyVector);
+	Add((t + "/MakeProjection").c_str(), [](V b) { return MakeProjection(b); }, anyVector);
+	Add((t + "/MakeRejection").c_str(), [](V b) { return MakeRejection(b); }, anyVector);
+	Add((t + "/operator<<").c_str(), [](const M& m) { return (bool)(nullStream << m); }, any);
+}
+
+// The arrays of n quaternions or 3x3 matrices in SoA form, each component taking n floats of data
+static QuaternionSoA Components(float* data, size_t n)
+{
+	QuaternionSoA q = { data, data + n, data + 2 * n, data + 3 * n };
+	return q;
+}
+
+static Matrix3DSoA Columns(float* data, size_t n)
+{
+	Matrix3DSoA m;
+	for (int k = 0; k < 9; k++)
+	{
+		m.n[k] = data + k * n;
+	}
+	return m;
+}
+
+// Any kind of 4x4 matrix, so that Inverses takes all of its paths in a random order
+static Matrix4D MixedMatrix4(Random& r)
+{
+	int kind = Index3(r);
+	return (kind == 0) ? AnyMatrix4(r) : (kind == 1) ? AffineMatrix4(r) : RigidMatrix4(r);
+}
+
+static const int BONES = 64;
+
+static DualQuaternion AnyBone(Random& r) { return MakeDualQuaternion(UnitQuaternion(r), AnyVector3(r)); }
+static SkinWeights AnySkinWeights(Random& r)
+{
+	SkinWeights s;
+	float total = 0;
+	for (int k = 0; k < 4; k++)
+	{
+		s.bone[k] = (unsigned short)r.Uniform(0, BONES - 0.01f);
+		s.weight[k] = Fraction(r);
+		total += s.weight[k];
+	}
+	for (int k = 0; k < 4; k++)
+	{
+		s.weight[k] /= total;
+	}
+	return s;
+}
+
+// The skeleton of every character: JOINTS joints, each with a parent chosen at random from the joints before it
+static const int JOINTS = 64;
+
+static Skeleton AnySkeleton(Random& r)
+{
+	int parents[JOINTS];
+	for (int i = 0; i < JOINTS; i++)
+	{
+		parents[i] = (i == 0) ? -1 : (int)r.Uniform(0, i - 0.01f);
+	}
+	return MakeSkeleton(parents, JOINTS);
+}
+
+static JointTransform AnyJointTransform(Random& r) { return JointTransform(UnitQuaternion(r), AnyVector3(r)); }
+
+// The data PoseEvaluator reads and writes. The jobs point into it, so it is kept in one place and never copied.
+struct PoseData
+{
+	Skeleton skeleton;
+	AnimationClip clip;
+	std::vector<PoseLayer> layers;
+	std::vector<JointTransform> world;
+	std::vector<PoseJob> jobs;
+	PoseEvaluator evaluator;
+
+	PoseData() : evaluator(1) {}
+};
+
+static StreamRecord AnyStreamRecord(Random& r)
+{
+	StreamRecord record = {};
+	int op = Index3(r);
+	Quaternion q = UnitQuaternion(r);
+	Quaternion s = (op == 2) ? AnyQuaternion(r) : UnitQuaternion(r);
+	float args[9] = { q.w, q.x, q.y, q.z, s.w, s.x, s.y, s.z, Fraction(r) };
+	Vector3D v = AnyVector3(r);
+
+	record.op = (op == 0) ? StreamOp::Slerp : (op == 1) ? StreamOp::Rotate : StreamOp::Mul;
+	for (int k = 0; k < ((op == 0) ? 9 : (op == 1) ? 4 : 8); k++)
+	{
+		record.args[k] = args[k];
+	}
+	if (op == 1)
+	{
+		record.args[4] = v.x;
+		record.args[5] = v.y;
+		record.args[6] = v.z;
+	}
+	return record;
+}
+
+// The record as a line of the text form
+static std::string FormatStreamRecord(const StreamRecord& record)
+{
+	static const char* const names[] = { "", "slerp", "rotate", "mul" };
+	int count = (record.op == StreamOp::Slerp) ? 9 : (record.op == StreamOp::Rotate) ? 7 : 8;
+
+	std::string line = names[(int)record.op];
+	char number[32];
+	for (int k = 0; k < count; k++)
+	{
+		snprintf(number, sizeof(number), " %.9g", record.args[k]);
+		line += number;
+	}
+	return line + "\n";
+}
+
+// A temporary file holding size bytes of data, which is closed when the last pass using it is gone.
+// Benchmarks have no way to fail, so the program stops if the file can't be made.
+static std::shared_ptr<FILE> TemporaryFile(const void* data, size_t size)
+{
+	FILE* file = tmpfile();
+	if (file == nullptr || fwrite(data, 1, size, file) != size)
+	{
+		fprintf(stderr, "can't write a temporary file\n");
+		exit(2);
+	}
+	return std::shared_ptr<FILE>(file, fclose);
+}
+
+// Times the whole stream mode on count records: parsing in, batching, and formatting out
+static Pass StreamPass(const void* data, size_t size, size_t count, StreamFormat format)
+{
+	std::shared_ptr<FILE> in = TemporaryFile(data, size);
+	std::shared_ptr<FILE> out = TemporaryFile(data, 0);
+
+	return [in, out, count, format]()
+	{
+		rewind(in.get());
+		rewind(out.get());
+		if (!ProcessStream(in.get(), out.get(), format))
+		{
+			exit(2);
+		}
+		return count;
+	};
+}
+
+// The functions of QuaternionBatch.h, MatrixBatch.h, Skinning.h, Skeleton.h, PoseEvaluator.h and QuaternionStream.h.
+// All of them run on the calling thread, so the numbers are for one core.
+static void AddBatchBenchmarks()
+{
+	AddBatch("QuaternionBatch/SlerpBatch", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, 13 * sizeof(float));
+		Random random;
+		std::vector<float> a(4 * n), b(4 * n), out(4 * n);
+		ToSoA(Inputs(UnitQuaternion, random, n).data(), Components(a.data(), n), (int)n);
+		ToSoA(Inputs(UnitQuaternion, random, n).data(), Components(b.data(), n), (int)n);
+		std::vector<float> t = Inputs(Fraction, random, n);
+
+		return Pass([a = std::move(a), b = std::move(b), t = std::move(t), out = std::move(out), n]() mutable
+		{
+			SlerpBatch(Components(a.data(), n), Components(b.data(), n), t.data(), Components(out.data(), n), (int)n);
+			return n;
+		});
+	});
+	AddBatch("QuaternionBatch/RotateVectors(q)", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, 2 * sizeof(Vector3D));
+		Random random;
+		Quaternion q = UnitQuaternion(random);
+		std::vector<Vector3D> in = Inputs(AnyVector3, random, n), out(n);
+
+		return Pass([q, in = std::move(in), out = std::move(out), n]() mutable
+		{
+			RotateVectors(q, in.data(), out.data(), (int)n);
+			return n;
+		});
+	});
+	AddBatch("QuaternionBatch/RotateVectors(q[i])", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, sizeof(Quaternion) + 2 * sizeof(Vector3D));
+		Random random;
+		std::vector<Quaternion> q = Inputs(UnitQuaternion, random, n);
+		std::vector<Vector3D> in = Inputs(AnyVector3, random, n), out(n);
+
+		return Pass([q = std::move(q), in = std::move(in), out = std::move(out), n]() mutable
+		{
+			RotateVectors(q.data(), in.data(), out.data(), (int)n);
+			return n;
+		});
+	});
+
+	AddBatch("MatrixBatch/MultiplyMatrices", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, 3 * sizeof(Matrix4D));
+		Random random;
+		std::vector<Matrix4D> l = Inputs(AnyMatrix4, random, n), r = Inputs(AnyMatrix4, random, n), out(n);
+
+		return Pass([l = std::move(l), r = std::move(r), out = std::move(out), n]() mutable
+		{
+			MultiplyMatrices(l.data(), r.data(), out.data(), (int)n);
+			return n;
+		});
+	});
+	// ComposeChain works in place, and repeating it on its own output would grow the translations without bound,
+	//  so each pass copies the chain first, which adds a 64 byte copy per matrix.
+	AddBatch("MatrixBatch/ComposeChain", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, 2 * sizeof(Matrix4D));
+		Random random;
+		std::vector<Matrix4D> chain = Inputs(RigidMatrix4, random, n), work(n);
+
+		return Pass([chain = std::move(chain), work = std::move(work), n]() mutable
+		{
+			std::copy(chain.begin(), chain.end(), work.begin());
+			ComposeChain(work.data(), (int)n);
+			return n;
+		});
+	});
+	AddBatch("MatrixBatch/Inverses(Matrix4D)", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, 2 * sizeof(Matrix4D) + sizeof(MatrixClass));
+		Random random;
+		std::vector<Matrix4D> m = Inputs(MixedMatrix4, random, n), out(n);
+		std::vector<MatrixClass> c(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			c[i] = Classify(m[i]);
+		}
+
+		return Pass([m = std::move(m), c = std::move(c), out = std::move(out), n]() mutable
+		{
+			Inverses(m.data(), c.data(), out.data(), (int)n);
+			return n;
+		});
+	});
+	AddBatch("MatrixBatch/Determinants", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, 10 * sizeof(float));
+		Random random;
+		std::vector<float> m(9 * n), out(n);
+		ToSoA(Inputs(AnyMatrix3, random, n).data(), Columns(m.data(), n), (int)n);
+
+		return Pass([m = std::move(m), out = std::move(out), n]() mutable
+		{
+			Determinants(Columns(m.data(), n), out.data(), (int)n);
+			return n;
+		});
+	});
+	AddBatch("MatrixBatch/Inverses(Matrix3DSoA)", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, 18 * sizeof(float));
+		Random random;
+		std::vector<float> m(9 * n), out(9 * n);
+		ToSoA(Inputs(AnyMatrix3, random, n).data(), Columns(m.data(), n), (int)n);
+
+		return Pass([m = std::move(m), out = std::move(out), n]() mutable
+		{
+			Inverses(Columns(m.data(), n), Columns(out.data(), n), (int)n);
+			return n;
+		});
+	});
+	AddBatch("MatrixBatch/Adjugates(Matrix3D)", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, 2 * sizeof(Matrix3D));
+		Random random;
+		std::vector<Matrix3D> m = Inputs(AnyMatrix3, random, n), out(n);
+
+		return Pass([m = std::move(m), out = std::move(out), n]() mutable
+		{
+			Adjugates(m.data(), out.data(), (int)n);
+			return n;
+		});
+	});
+	AddBatch("MatrixBatch/Adjugates(Matrix4D)", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, 2 * sizeof(Matrix4D));
+		Random random;
+		std::vector<Matrix4D> m = Inputs(AnyMatrix4, random, n), out(n);
+
+		return Pass([m = std::move(m), out = std::move(out), n]() mutable
+		{
+			Adjugates(m.data(), out.data(), (int)n);
+			return n;
+		});
+	});
+	AddBatch("MatrixBatch/CofactorMatrices(Matrix3D)", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, 2 * sizeof(Matrix3D));
+		Random random;
+		std::vector<Matrix3D> m = Inputs(AnyMatrix3, random, n), out(n);
+
+		return Pass([m = std::move(m), out = std::move(out), n]() mutable
+		{
+			CofactorMatrices(m.data(), out.data(), (int)n);
+			return n;
+		});
+	});
+	AddBatch("MatrixBatch/CofactorMatrices(Matrix4D)", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, 2 * sizeof(Matrix4D));
+		Random random;
+		std::vector<Matrix4D> m = Inputs(AnyMatrix4, random, n), out(n);
+
+		return Pass([m = std::move(m), out = std::move(out), n]() mutable
+		{
+			CofactorMatrices(m.data(), out.data(), (int)n);
+			return n;
+		});
+	});
+	AddBatch("MatrixBatch/NormalMatrices", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, sizeof(Matrix4D) + sizeof(Matrix3D));
+		Random random;
+		std::vector<Matrix4D> m = Inputs(AffineMatrix4, random, n);
+		std::vector<Matrix3D> out(n);
+
+		return Pass([m = std::move(m), out = std::move(out), n]() mutable
+		{
+			NormalMatrices(m.data(), out.data(), (int)n);
+			return n;
+		});
+	});
+
+	// Per vertex, with every vertex blending 4 of 64 bones
+	AddBatch("Skinning/SkinVertices", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, sizeof(SkinWeights) + 4 * sizeof(Vector3D));
+		Random random;
+		std::vector<DualQuaternion> bones = Inputs(AnyBone, random, BONES);
+		std::vector<SkinWeights> weights = Inputs(AnySkinWeights, random, n);
+		std::vector<Vector3D> positions = Inputs(AnyVector3, random, n), normals = Inputs(UnitVector3, random, n);
+		std::vector<Vector3D> outPositions(n), outNormals(n);
+
+		return Pass([bones = std::move(bones), weights = std::move(weights), positions = std::move(positions),
+			normals = std::move(normals), outPositions = std::move(outPositions), outNormals = std::move(outNormals), n]() mutable
+		{
+			SkinVertices(bones.data(), weights.data(), positions.data(), normals.data(),
+				outPositions.data(), outNormals.data(), (int)n);
+			return n;
+		});
+	});
+
+	// Per joint, over as many characters as fit, all sharing one skeleton
+	AddBatch("Skeleton/ComputeWorldTransforms", [](size_t bytes)
+	{
+		size_t characters = Elements(bytes, 2 * JOINTS * sizeof(JointTransform));
+		Random random;
+		Skeleton skeleton = AnySkeleton(random);
+		std::vector<JointTransform> local = Inputs(AnyJointTransform, random, characters * JOINTS), world(characters * JOINTS);
+
+		return Pass([skeleton = std::move(skeleton), local = std::move(local), world = std::move(world), characters]() mutable
+		{
+			ComputeWorldTransforms(skeleton, local.data(), world.data(), (int)characters);
+			return characters * JOINTS;
+		});
+	});
+
+	// Per joint, with each character blending two layers of a 64 joint clip with 30 keys per track.
+	// The working set counts what each character has to itself; the clip is shared by all of them.
+	AddBatch("PoseEvaluator/Evaluate", [](size_t bytes)
+	{
+		size_t characters = Elements(bytes, JOINTS * sizeof(JointTransform) + 2 * sizeof(PoseLayer) + sizeof(PoseJob));
+		Random random;
+		std::shared_ptr<PoseData> data = std::make_shared<PoseData>();
+		data->skeleton = AnySkeleton(random);
+		data->clip.rotations.resize(JOINTS);
+		for (int j = 0; j < JOINTS; j++)
+		{
+			for (int k = 0; k < 30; k++)
+			{
+				data->clip.rotations[j].AddKey(k / 30.0f, UnitQuaternion(random));
+			}
+			data->clip.translations.push_back(AnyVector3(random));
+		}
+
+		data->layers.resize(2 * characters);
+		data->world.resize(characters * JOINTS);
+		data->jobs.resize(characters);
+		for (size_t c = 0; c < characters; c++)
+		{
+			data->layers[2 * c] = PoseLayer{ &data->clip, Fraction(random), 0.7f };
+			data->layers[2 * c + 1] = PoseLayer{ &data->clip, Fraction(random), 0.3f };
+			data->jobs[c] = PoseJob{ &data->skeleton, &data->layers[2 * c], 2, &data->world[c * JOINTS] };
+		}
+
+		return Pass([data, characters]()
+		{
+			data->evaluator.Evaluate(data->jobs.data(), (int)characters);
+			return characters * JOINTS;
+		});
+	});
+
+	// Per record, with slerp, rotate and mul records in a random order.
+	// A text record is about 110 bytes of input and 50 of output.
+	AddBatch("QuaternionStream/ProcessStream(Text)", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, 160);
+		Random random;
+		std::string text;
+		for (size_t i = 0; i < n; i++)
+		{
+			text += FormatStreamRecord(AnyStreamRecord(random));
+		}
+		return StreamPass(text.data(), text.size(), n, StreamFormat::Text);
+	});
+	AddBatch("QuaternionStream/ProcessStream(Binary)", [](size_t bytes)
+	{
+		size_t n = Elements(bytes, sizeof(StreamRecord) + sizeof(StreamResult));
+		Random random;
+		std::vector<StreamRecord> records = Inputs(AnyStreamRecord, random, n);
+		return StreamPass(records.data(), n * sizeof(StreamRecord), n, StreamFormat::Binary);
+	});
+}
+
+static void AddBenchmarks()
+{
+	AddQuaternionBenchmarks("Quaternion", AnyFloat, Positive, Fraction, AnyQuaternion, UnitQuaternion);
+	// The functions that make a rotation from an axis or a matrix only exist for Quaternion
+	Add("Quaternion/Rotation(v,a)", [](Vector3D v, float a) { return Rotation(v, a); }, UnitVector3, Angle);
+	Add("Quaternion/Rotation(Matrix3D)", [](const Matrix3D& m) { return Rotation(m); }, RotationMatrix3);
+	Add("Quaternion/Rotation(Matrix4D)", [](const Matrix4D& m) { return Rotation(m); }, RigidMatrix4);
+	Add("Quaternion/ConstexprRotation", [](Vector3D v, float a) { return ConstexprRotation(v, a); }, UnitVector3, Angle);
+	AddQuaternionBenchmarks("QuaternionD", AnyDouble, PositiveDouble, FractionDouble, AnyQuaternionD, UnitQuaternionD);
+
+	AddVectorBenchmarks("Vector2D", AnyVector2);
+	AddVectorBenchmarks("Vector3D", AnyVector3);
+	Add("Vector3D/Cross", [](Vector3D a, Vector3D b) { return Cross(a, b); }, AnyVector3, AnyVector3);
+	Add("Vector3D/ScalarTriple", [](Vector3D a, Vector3D b, Vector3D c) { return ScalarTriple(a, b, c); },
+		AnyVector3, AnyVector3, AnyVector3);
+	AddVectorBenchmarks("Vector4D", AnyVector4);
+	Add("Vector4D/Pointify", [](Vector4D v) { return Pointify(v); }, AnyVector4);
+
+	AddMatrixBenchmarks("Matrix2D", AnyMatrix2, AnyVector2, Index2);
+	Add("Matrix2D/MakeRotation", [](float theta) { return MakeRotation(theta); }, Angle);
+	Add("Matrix2D/ReflectMatrix", [](const Matrix2D& m, const Matrix2D& r) { return ReflectMatrix(m, r); }, AnyMatrix2, AnyMatrix2);
+
+	AddMatrixBenchmarks("Matrix3D", AnyMatrix3, AnyVector3, Index3);
+	Add("Matrix3D/MakeRotationX", [](float theta) { return MakeRotationX(theta); }, Angle);
+	Add("Matrix3D/MakeRotationY", [](float theta) { return MakeRotationY(theta); }, Angle);
+	Add("Matrix3D/MakeRotationZ", [](float theta) { return MakeRotationZ(theta); }, Angle);
+	Add("Matrix3D/MakeRotation", [](float theta, Vector3D v) { return MakeRotation(theta, v); }, Angle, UnitVector3);
+	Add("Matrix3D/ConstexprRotationX", [](float theta) { return ConstexprRotationX(theta); }, Angle);
+	Add("Matrix3D/ConstexprRotationY", [](float theta) { return ConstexprRotationY(theta); }, Angle);
+	Add("Matrix3D/ConstexprRotationZ", [](float theta) { return ConstexprRotationZ(theta); }, Angle);
+	Add("Matrix3D/CrossMat", [](Vector3D a) { return CrossMat(a); }, AnyVector3);
+
+	AddMatrixBenchmarks("Matrix4D", AnyMatrix4, AnyVector4, Index4);
+	Add("Matrix4D/Classify", [](const Matrix4D& m) { return Classify(m); }, AffineMatrix4);
+	Add("Matrix4D/InverseAffine", [](const Matrix4D& m) { return InverseAffine(m); }, AffineMatrix4);
+	Add("Matrix4D/InverseRigid", [](const Matrix4D& m) { return InverseRigid(m); }, RigidMatrix4);
+	Add("Matrix4D/Inverse(m,Rigid)", [](const Matrix4D& m) { return Inverse(m, MatrixClass::Rigid); }, RigidMatrix4);
+
+	AddBatchBenchmarks();
+}
+
+// Writes the results one to a line, which is also the form ReadBaseline expects
+static bool WriteJson(const char* path, const std::vector<Result>& results)
+{
+	FILE* out = fopen(path, "w");
+	if (out == nullptr)
+	{
+		return false;
+	}
+
+	fprintf(out, "{\n\"version\": 1,\n\"tsc\": %s,\n\"results\": [\n", HAVE_TSC ? "true" : "false");
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const Result& r = results[i];
+		fprintf(out, "{\"name\": \"%s\", \"size\": \"%s\", \"bytes\": %zu, \"ns_per_op\": %.6g, \"ops_per_s\": %.6g, \"tsc_per_op\": ",
+			r.name.c_str(), r.size.c_str(), r.bytes, r.nsPerOp, r.opsPerSecond);
+		if (HAVE_TSC)
+		{
+			fprintf(out, "%.6g}", r.tscPerOp);
+		}
+		else
+		{
+			fprintf(out, "null}");
+		}
+		fprintf(out, "%s\n", (i + 1 < results.size()) ? "," : "");
+	}
+	fprintf(out, "]\n}\n");
+
+	return fclose(out) == 0;
+}
+
+// Finds "key": in line and returns what follows it, as a string (without its quotes) or a number
+static std::string JsonField(const std::string& line, const char* key)
+{
+	std::string quoted = std::string("\"") + key + "\":";
+	size_t at = line.find(quoted);
+	if (at == std::string::npos)
+	{
+		return std::string();
+	}
+
+	at = line.find_first_not_of(' ', at + quoted.size());
+	if (at == std::string::npos)
+	{
+		return std::string();
+	}
+	if (line[at] == '"')
+	{
+		size_t end = line.find('"', at + 1);
+		return (end == std::string::npos) ? std::string() : line.substr(at + 1, end - at - 1);
+	}
+
+	size_t end = line.find_first_of(",}", at);
+	return line.substr(at, (end == std::string::npos) ? std::string::npos : end - at);
+}
+
+// Reads the ns per call of each benchmark and size from a file written by WriteJson
+static bool ReadBaseline(const char* path, std::map<std::string, double>& baseline)
+{
+	FILE* in = fopen(path, "r");
+	if (in == nullptr)
+	{
+		return false;
+	}
+
+	char buffer[1024];
+	while (fgets(buffer, sizeof(buffer), in) != nullptr)
+	{
+		std::string line = buffer;
+		std::string name = JsonField(line, "name");
+		std::string size = JsonField(line, "size");
+		std::string ns = JsonField(line, "ns_per_op");
+
+		if (!name.empty() && !size.empty() && !ns.empty())
+		{
+			baseline[name + " " + size] = atof(ns.c_str());
+		}
+	}
+
+	fclose(in);
+	return true;
+}
+
+// Whether size is one of the comma separated names in sizes
+static bool SizeSelected(const std::string& sizes, const std::string& size)
+{
+	return ("," + sizes + ",").find("," + size + ",") != std::string::npos;
+}
+
+int main(int argc, char* argv[])
+{
+	std::string filter;
+	std::string sizes = "L1,L2,L3,DRAM";
+	double milliseconds = 20;
+	const char* jsonPath = nullptr;
+	const char* baselinePath = nullptr;
+	double threshold = 0.1;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = (i + 1 < argc);
+		if (strcmp(argv[i], "--filter") == 0 && hasValue)
+		{
+			filter = argv[++i];
+		}
+		else if (strcmp(argv[i], "--sizes") == 0 && hasValue)
+		{
+			sizes = argv[++i];
+		}
+		else if (strcmp(argv[i], "--time") == 0 && hasValue)
+		{
+			milliseconds = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--json") == 0 && hasValue)
+		{
+			jsonPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--baseline") == 0 && hasValue)
+		{
+			baselinePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--threshold") == 0 && hasValue)
+		{
+			threshold = atof(argv[++i]);
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [--filter text] [--sizes L1,L2,L3,DRAM] [--time ms]\n"
+				"       [--json out.json] [--baseline old.json] [--threshold 0.1]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	std::map<std::string, double> baseline;
+	if (baselinePath != nullptr && !ReadBaseline(baselinePath, baseline))
+	{
+		fprintf(stderr, "can't read %s\n", baselinePath);
+		return 2;
+	}
+
+	AddBenchmarks();
+
+	std::vector<Result> results;
+	std::set<std::string> measured;
+	int regressions = 0, added = 0;
+	printf("%-44s %-5s %12s %14s %12s\n", "benchmark", "size", "ns/op", "ops/s", HAVE_TSC ? "tsc/op" : "");
+
+	for (const Benchmark& b : benchmarks)
+	{
+		if (b.name.find(filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		for (const CacheSize& size : SIZES)
+		{
+			if (!SizeSelected(sizes, size.name))
+			{
+				continue;
+			}
+
+			Result r;
+			r.name = b.name;
+			r.size = size.name;
+			r.bytes = size.bytes;
+			b.measure(size.bytes, milliseconds / 1000, r.nsPerOp, r.tscPerOp);
+			r.opsPerSecond = 1e9 / r.nsPerOp;
+			results.push_back(r);
+
+			printf("%-44s %-5s %12.3f %14.4g", r.name.c_str(), r.size.c_str(), r.nsPerOp, r.opsPerSecond);
+			if (HAVE_TSC)
+			{
+				printf(" %12.2f", r.tscPerOp);
+			}
+
+			measured.insert(r.name + " " + r.size);
+			auto old = baseline.find(r.name + " " + r.size);
+			if (baselinePath != nullptr && old == baseline.end())
+			{
+				printf("  NEW, not in baseline");
+				added++;
+			}
+			else if (old != baseline.end() && r.nsPerOp > old->second * (1 + threshold))
+			{
+				printf("  SLOWER than %.3f (+%.0f%%)", old->second, 100 * (r.nsPerOp / old->second - 1));
+				regressions++;
+			}
+			printf("\n");
+			fflush(stdout);
+		}
+	}
+
+	// The keys are "name size", and names have no spaces
+	int missing = 0;
+	for (const auto& old : baseline)
+	{
+		size_t space = old.first.rfind(' ');
+		std::string name = old.first.substr(0, space);
+		std::string size = old.first.substr(space + 1);
+
+		if (measured.count(old.first) == 0 && name.find(filter) != std::string::npos && SizeSelected(sizes, size))
+		{
+			printf("%-44s %-5s %12.3f  MISSING, only in baseline\n", name.c_str(), size.c_str(), old.second);
+			missing++;
+		}
+	}
+
+	if (jsonPath != nullptr && !WriteJson(jsonPath, results))
+	{
+		fprintf(stderr, "can't write %s\n", jsonPath);
+		return 2;
+	}
+
+	if (baselinePath != nullptr)
+	{
+		printf("%d of %d results more than %.0f%% slower than %s\n", regressions, (int)results.size(), 100 * threshold, baselinePath);
+		printf("%d results not in %s, %d of its results missing\n", added, baselinePath, missing);
+	}
+
+	return (regressions > 0 || missing > 0) ? 1 : 0;
+}
@@ -0,0 +1,299 @@
+/*
+Title: Quaternion Math
+File Name: Checks.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Checks the math against the formulas it implements, written out by hand here, so that a wrong sign or index
+//  in an optimized version fails the build's tests instead of turning up later as a subtly wrong animation.
+// These cover the bugs that were fixed in the products, Conjugate, RotationMatrix and the averages of weights of 0,
+//  and the precision the Slerp functions promise in their comments.
+//
+//  QuaternionChecks
+//
+// Prints each failed check and returns 1 if any failed, so ctest reports it.
+#include "Matrix3D.h"
+#include "Matrix4D.h"
+#include "MatrixBatch.h"
+#include "Quaternion.h"
+#include "QuaternionAverage.h"
+#include "QuaternionBatch.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+static int checks = 0;
+static int failures = 0;
+
+static void Check(bool passed, const char* what)
+{
+	checks++;
+	if (!passed)
+	{
+		printf("FAILED: %s\n", what);
+		failures++;
+	}
+}
+
+static bool Near(double a, double b, double tolerance)
+{
+	return std::fabs(a - b) <= tolerance;
+}
+
+static bool Near(Quaternion q, double w, double x, double y, double z, double tolerance)
+{
+	return Near(q.w, w, tolerance) && Near(q.x, x, tolerance) && Near(q.y, y, tolerance) && Near(q.z, z, tolerance);
+}
+
+static bool Near(Vector3D v, double x, double y, double z, double tolerance)
+{
+	return Near(v.x, x, tolerance) && Near(v.y, y, tolerance) && Near(v.z, z, tolerance);
+}
+
+// The same xorshift64* generator as the benchmarks, so every run checks the same values
+struct Random
+{
+	uint64_t state;
+
+	Random() : state(0x9E3779B97F4A7C15ull) {}
+
+	float Uniform(float lo, float hi)
+	{
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		uint32_t bits = (uint32_t)((state * 0x2545F4914F6CDD1Dull) >> 40);
+		return lo + (hi - lo) * (float)bits * (1.0f / 16777216.0f);
+	}
+};
+
+static Quaternion AnyQuaternion(Random& r)
+{
+	return Quaternion(r.Uniform(-2, 2), r.Uniform(-2, 2), r.Uniform(-2, 2), r.Uniform(-2, 2));
+}
+
+static Quaternion UnitQuaternion(Random& r)
+{
+	return Normalize(AnyQuaternion(r) + Quaternion(0.01f, 0, 0, 0));
+}
+
+// Matrix4D * Matrix4D against the sum over k of l(i, k) * r(k, j), with the entries written to plain arrays first,
+//  and every row checked, since row 0 of the product was once made from row 2 of l.
+static void CheckMatrix4DProduct()
+{
+	Random random;
+	bool entries = true, rows = true, batched = true;
+	for (int trial = 0; trial < 100; trial++)
+	{
+		float a[4][4], b[4][4];
+		for (int i = 0; i < 4; i++)
+		{
+			for (int j = 0; j < 4; j++)
+			{
+				a[i][j] = random.Uniform(-2, 2);
+				b[i][j] = random.Uniform(-2, 2);
+			}
+		}
+
+		Matrix4D l(a[0][0], a[0][1], a[0][2], a[0][3], a[1][0], a[1][1], a[1][2], a[1][3],
+			a[2][0], a[2][1], a[2][2], a[2][3], a[3][0], a[3][1], a[3][2], a[3][3]);
+		Matrix4D r(b[0][0], b[0][1], b[0][2], b[0][3], b[1][0], b[1][1], b[1][2], b[1][3],
+			b[2][0], b[2][1], b[2][2], b[2][3], b[3][0], b[3][1], b[3][2], b[3][3]);
+		Matrix4D product = l * r;
+		Matrix4D batch;
+		MultiplyMatrices(&l, &r, &batch, 1);
+
+		for (int i = 0; i < 4; i++)
+		{
+			Vector4D row = product.row(i);
+			float rowEntries[4] = { row.x, row.y, row.z, row.w };
+			for (int j = 0; j < 4; j++)
+			{
+				double expected = 0;
+				for (int k = 0; k < 4; k++)
+				{
+					expected += (double)a[i][k] * b[k][j];
+				}
+				entries = entries && Near(product(i, j), expected, 1e-5);
+				rows = rows && Near(rowEntries[j], expected, 1e-5);
+				batched = batched && Near(batch(i, j), expected, 1e-5);
+			}
+		}
+	}
+	Check(entries, "Matrix4D * Matrix4D matches the sum over k of l(i, k) * r(k, j)");
+	Check(rows, "every row of Matrix4D * Matrix4D matches the row of l times r");
+	Check(batched, "MultiplyMatrices matches the sum over k of l(i, k) * r(k, j)");
+}
+
+// The Hamilton product: i^2 = j^2 = k^2 = ijk = -1, and for q = [a, u] and r = [b, v],
+//  q * r = [ab - u.v, a v + b u + u x v]
+static void CheckHamiltonProduct()
+{
+	const Quaternion one(1, 0, 0, 0), i(0, 1, 0, 0), j(0, 0, 1, 0), k(0, 0, 0, 1);
+	Check(Near(i * i, -1, 0, 0, 0, 0) && Near(j * j, -1, 0, 0, 0, 0) && Near(k * k, -1, 0, 0, 0, 0), "i^2 = j^2 = k^2 = -1");
+	Check(Near(i * j * k, -1, 0, 0, 0, 0), "ijk = -1");
+	Check(Near(i * j, 0, 0, 0, 1, 0) && Near(j * k, 0, 1, 0, 0, 0) && Near(k * i, 0, 0, 1, 0, 0), "ij = k, jk = i, ki = j");
+	Check(Near(j * i, 0, 0, 0, -1, 0) && Near(k * j, 0, -1, 0, 0, 0) && Near(i * k, 0, 0, -1, 0, 0), "ji = -k, kj = -i, ik = -j");
+	Check(Near(one * i, 0, 1, 0, 0, 0) && Near(i * one, 0, 1, 0, 0, 0), "1 is the identity of the product");
+
+	Random random;
+	bool formula = true, unit = true;
+	for (int trial = 0; trial < 1000; trial++)
+	{
+		Quaternion q = AnyQuaternion(random), r = AnyQuaternion(random);
+		double a = q.w, ux = q.x, uy = q.y, uz = q.z;
+		double b = r.w, vx = r.x, vy = r.y, vz = r.z;
+		Quaternion p = q * r;
+		formula = formula && Near(p, a * b - (ux * vx + uy * vy + uz * vz),
+			a * vx + b * ux + (uy * vz - uz * vy),
+			a * vy + b * uy + (uz * vx - ux * vz),
+			a * vz + b * uz + (ux * vy - uy * vx), 1e-5);
+
+		Quaternion s = UnitQuaternion(random), t = UnitQuaternion(random);
+		unit = unit && Near(Magnitude(s * t), 1, 1e-6);
+	}
+	Check(formula, "q * r = [ab - u.v, a v + b u + u x v]");
+	Check(unit, "products of unit quaternions are unit quaternions");
+}
+
+// Conjugate negates x, y and z, and q * Conjugate(q) = [|q|^2, 0]
+static void CheckConjugate()
+{
+	Check(Near(Conjugate(Quaternion(1, 2, 3, 4)), 1, -2, -3, -4, 0), "Conjugate([1, 2, 3, 4]) = [1, -2, -3, -4]");
+
+	Random random;
+	bool norm = true;
+	for (int trial = 0; trial < 1000; trial++)
+	{
+		Quaternion q = AnyQuaternion(random);
+		norm = norm && Near(q * Conjugate(q), Norm(q), 0, 0, 0, 1e-5);
+	}
+	Check(norm, "q * Conjugate(q) = [Norm(q), 0, 0, 0]");
+}
+
+// RotationMatrix turns vectors the same way as q * [0, v] * Conjugate(q), counter-clockwise about the axis,
+//  and the rotation by Conjugate(q) is its transpose, since RotationMatrix was once built transposed.
+static void CheckRotationMatrix()
+{
+	const float halfPi = 1.57079632679489662f;
+	Quaternion z90 = Rotation(Vector3D(0, 0, 1), halfPi);
+	Check(Near(RotationMatrix(z90) * Vector3D(1, 0, 0), 0, 1, 0, 1e-6), "a quarter turn about z takes x to y");
+	Check(Near(RotateVector(Vector3D(1, 0, 0), z90), 0, 1, 0, 1e-6), "RotateVector turns a quarter turn about z from x to y");
+	Check(Near(RotationMatrix(Rotation(Vector3D(1, 0, 0), halfPi)) * Vector3D(0, 1, 0), 0, 0, 1, 1e-6),
+		"a quarter turn about x takes y to z");
+
+	Random random;
+	bool sandwich = true, transpose = true, batched = true;
+	for (int trial = 0; trial < 1000; trial++)
+	{
+		Quaternion q = UnitQuaternion(random);
+		Vector3D v(random.Uniform(-2, 2), random.Uniform(-2, 2), random.Uniform(-2, 2));
+		Quaternion p = q * Quaternion(0, v) * Conjugate(q);
+		Matrix3D m = RotationMatrix(q);
+		Matrix3D t = RotationMatrix(Conjugate(q));
+		Vector3D rotated;
+		RotateVectors(&q, &v, &rotated, 1);
+
+		sandwich = sandwich && Near(m * v, p.x, p.y, p.z, 1e-5) && Near(RotateVector(v, q), p.x, p.y, p.z, 1e-5);
+		batched = batched && Near(rotated, p.x, p.y, p.z, 1e-5);
+		for (int i = 0; i < 3; i++)
+		{
+			for (int j = 0; j < 3; j++)
+			{
+				transpose = transpose && Near(t(i, j), m(j, i), 1e-6);
+			}
+		}
+	}
+	Check(sandwich, "RotationMatrix(q) * v and RotateVector(v, q) equal q * [0, v] * Conjugate(q)");
+	Check(batched, "RotateVectors equals q * [0, v] * Conjugate(q)");
+	Check(transpose, "RotationMatrix(Conjugate(q)) is the transpose of RotationMatrix(q)");
+}
+
+// The float Slerp and SlerpBatch against Slerp in double, to the bound given for SlerpBatch in QuaternionBatch.h,
+//  for unit quaternions with Dot(a, b) >= -0.9
+static void CheckSlerpPrecision()
+{
+	const int count = 10000;
+	Random random;
+	std::vector<Quaternion> a, b;
+	std::vector<float> t;
+	while ((int)a.size() < count)
+	{
+		Quaternion p = UnitQuaternion(random), q = UnitQuaternion(random);
+		if (Dot(p, q) >= -0.9f)
+		{
+			a.push_back(p);
+			b.push_back(q);
+			t.push_back(random.Uniform(0, 1));
+		}
+	}
+
+	std::vector<float> soa(12 * count);
+	QuaternionSoA sa = { &soa[0], &soa[count], &soa[2 * count], &soa[3 * count] };
+	QuaternionSoA sb = { &soa[4 * count], &soa[5 * count], &soa[6 * count], &soa[7 * count] };
+	QuaternionSoA so = { &soa[8 * count], &soa[9 * count], &soa[10 * count], &soa[11 * count] };
+	std::vector<Quaternion> batch(count);
+	ToSoA(a.data(), sa, count);
+	ToSoA(b.data(), sb, count);
+	SlerpBatch(sa, sb, t.data(), so, count);
+	FromSoA(so, batch.data(), count);
+
+	bool scalar = true, batched = true;
+	for (int i = 0; i < count; i++)
+	{
+		QuaternionD e = Slerp(QuaternionD(a[i]), QuaternionD(b[i]), (double)t[i]);
+		scalar = scalar && Near(Slerp(a[i], b[i], t[i]), e.w, e.x, e.y, e.z, 6e-7);
+		batched = batched && Near(batch[i], e.w, e.x, e.y, e.z, 6e-7);
+	}
+	Check(scalar, "Slerp in float is within 5 ULPs of 1.0f of Slerp in double");
+	Check(batched, "SlerpBatch is within 5 ULPs of 1.0f of Slerp in double");
+}
+
+// Weights that are all 0 average to the identity with both methods, for one joint and for a batch
+static void CheckZeroWeightAverage()
+{
+	Quaternion q[2] = { Quaternion(0, 1, 0, 0), Quaternion(0.5f, 0.5f, 0.5f, 0.5f) };
+	float weights[2] = { 0, 0 };
+	float w[2] = { 0, 0.5f }, x[2] = { 1, 0.5f }, y[2] = { 0, 0.5f }, z[2] = { 0, 0.5f };
+	float ow[2], ox[2], oy[2], oz[2];
+	QuaternionSoA layers[2] = { { &w[0], &x[0], &y[0], &z[0] }, { &w[1], &x[1], &y[1], &z[1] } };
+	QuaternionSoA out = { ow, ox, oy, oz };
+
+	AverageMethod methods[2] = { AverageMethod::NormalizedSum, AverageMethod::Eigenvector };
+	for (AverageMethod method : methods)
+	{
+		AverageQuaternions(layers, weights, 2, out, 1, method);
+		bool identity = Near(AverageQuaternions(q, weights, 2, method), 1, 0, 0, 0, 0)
+			&& Near(Quaternion(ow[0], ox[0], oy[0], oz[0]), 1, 0, 0, 0, 0);
+		Check(identity, (method == AverageMethod::Eigenvector) ? "Eigenvector averages weights of 0 to the identity"
+			: "NormalizedSum averages weights of 0 to the identity");
+	}
+}
+
+int main()
+{
+	CheckMatrix4DProduct();
+	CheckHamiltonProduct();
+	CheckConjugate();
+	CheckRotationMatrix();
+	CheckSlerpPrecision();
+	CheckZeroWeightAverage();
+
+	printf("%d of %d checks failed\n", failures, checks);
+	return (failures > 0) ? 1 : 0;
+}
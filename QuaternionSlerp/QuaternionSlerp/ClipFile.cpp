@@ -0,0 +1,393 @@
+/*
+Title: Quaternion Math
+File Name: ClipFile.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "ClipFile.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char CLIP_MAGIC[8] = { 'Q', 'C', 'L', 'I', 'P', 0, 0, 0 };
+
+// The file is read through these structs, so their layout is part of the format
+static_assert(sizeof(ClipFileHeader) == 64, "ClipFileHeader must be 64 bytes");
+static_assert(sizeof(ClipFileTrack) == 40, "ClipFileTrack must be 40 bytes");
+static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion keys are stored as 4 floats");
+
+static uint64_t AlignUp(uint64_t offset)
+{
+	return (offset + CLIP_ALIGNMENT - 1) / CLIP_ALIGNMENT * CLIP_ALIGNMENT;
+}
+
+Quaternion ClipTrackView::Key(int i) const
+{
+	return (keys != nullptr) ? keys[i] : Quaternion(soa.w[i], soa.x[i], soa.y[i], soa.z[i]);
+}
+
+Quaternion ClipTrackView::Evaluate(float t, TrackCursor& cursor) const
+{
+	int segment = FindSegment(times, keyCount, t, cursor);
+
+	if (t <= times[segment])
+	{
+		return Key(segment);
+	}
+	if (segment + 1 >= keyCount || t >= times[segment + 1])
+	{
+		return Key((segment + 1 < keyCount) ? segment + 1 : segment);
+	}
+
+	return Slerp(Key(segment), Key(segment + 1), SegmentFraction(times, keyCount, segment, t));
+}
+
+MappedClip::MappedClip()
+	: data(nullptr), size(0)
+#ifdef _WIN32
+	, file(INVALID_HANDLE_VALUE), mapping(nullptr)
+#endif
+{
+}
+
+MappedClip::~MappedClip()
+{
+	Close();
+}
+
+// Checks everything that Track relies on, so that a damaged or truncated file can't send a view outside the mapping
+static bool IsValidClip(const char* data, size_t size)
+{
+	if (size < sizeof(ClipFileHeader))
+	{
+		return false;
+	}
+
+	const ClipFileHeader* header = (const ClipFileHeader*)data;
+	if (memcmp(header->magic, CLIP_MAGIC, sizeof(CLIP_MAGIC)) != 0 || header->version != CLIP_VERSION
+		|| header->byteOrder != CLIP_BYTE_ORDER || header->fileSize != size
+		|| (header->layout != (uint32_t)ClipLayout::AoS && header->layout != (uint32_t)ClipLayout::SoA))
+	{
+		return false;
+	}
+
+	uint64_t tracksEnd = header->tracksOffset + (uint64_t)header->trackCount * sizeof(ClipFileTrack);
+	if (header->tracksOffset % alignof(ClipFileTrack) != 0 || header->tracksOffset > size || tracksEnd > size)
+	{
+		return false;
+	}
+
+	const ClipFileTrack* tracks = (const ClipFileTrack*)(data + header->tracksOffset);
+	for (uint32_t i = 0; i < header->trackCount; i++)
+	{
+		const ClipFileTrack& track = tracks[i];
+		uint64_t keyBytes = (header->layout == (uint32_t)ClipLayout::AoS)
+			? (uint64_t)track.keyCount * sizeof(Quaternion)
+			: 3 * (uint64_t)track.componentStride + (uint64_t)track.keyCount * sizeof(float);
+
+		if (track.keyCount == 0 || track.keyCount > (uint32_t)INT32_MAX
+			|| track.timesOffset % CLIP_ALIGNMENT != 0 || track.keysOffset % CLIP_ALIGNMENT != 0
+			|| track.componentStride % CLIP_ALIGNMENT != 0
+			|| (header->layout == (uint32_t)ClipLayout::SoA && track.componentStride < track.keyCount * sizeof(float))
+			|| track.timesOffset > size || (uint64_t)track.keyCount * sizeof(float) > size - track.timesOffset
+			|| track.keysOffset > size || keyBytes > size - track.keysOffset)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool MappedClip::Open(const char* path)
+{
+	Close();
+
+#ifdef _WIN32
+	file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	LARGE_INTEGER fileSize;
+	if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	// PAGE_WRITECOPY and FILE_MAP_COPY make the view copy-on-write, the same as MAP_PRIVATE
+	mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	data = (mapping != nullptr) ? (char*)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0) : nullptr;
+	if (data == nullptr)
+	{
+		Close();
+		return false;
+	}
+	size = (size_t)fileSize.QuadPart;
+#else
+	int fd = open(path, O_RDONLY);
+	struct stat status;
+	if (fd < 0 || fstat(fd, &status) != 0 || status.st_size == 0)
+	{
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return false;
+	}
+
+	// MAP_PRIVATE shares the file's pages with every other process that maps it, until one of them writes to a page.
+	// The mapping holds its own reference to the file, so the descriptor isn't needed after this.
+	void* mapped = mmap(nullptr, (size_t)status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapped == MAP_FAILED)
+	{
+		return false;
+	}
+	data = (char*)mapped;
+	size = (size_t)status.st_size;
+#endif
+
+	if (!IsValidClip(data, size))
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void MappedClip::Close()
+{
+#ifdef _WIN32
+	if (data != nullptr)
+	{
+		UnmapViewOfFile(data);
+	}
+	if (mapping != nullptr)
+	{
+		CloseHandle(mapping);
+	}
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(file);
+	}
+	mapping = nullptr;
+	file = INVALID_HANDLE_VALUE;
+#else
+	if (data != nullptr)
+	{
+		munmap(data, size);
+	}
+#endif
+
+	data = nullptr;
+	size = 0;
+}
+
+bool MappedClip::IsOpen() const
+{
+	return data != nullptr;
+}
+
+const ClipFileHeader* MappedClip::Header() const
+{
+	return (const ClipFileHeader*)data;
+}
+
+ClipLayout MappedClip::Layout() const
+{
+	return (ClipLayout)Header()->layout;
+}
+
+int MappedClip::TrackCount() const
+{
+	return (data != nullptr) ? (int)Header()->trackCount : 0;
+}
+
+ClipTrackView MappedClip::Track(int i) const
+{
+	const ClipFileTrack& track = ((const ClipFileTrack*)(data + Header()->tracksOffset))[i];
+	ClipTrackView view;
+
+	view.keyCount = (int)track.keyCount;
+	view.times = (const float*)(data + track.timesOffset);
+	view.translation = Vector3D(track.translation[0], track.translation[1], track.translation[2]);
+
+	if (Layout() == ClipLayout::AoS)
+	{
+		view.keys = (const Quaternion*)(data + track.keysOffset);
+		view.soa = QuaternionSoA{ nullptr, nullptr, nullptr, nullptr };
+	}
+	else
+	{
+		char* w = data + track.keysOffset;
+		view.keys = nullptr;
+		view.soa = QuaternionSoA{ (float*)w, (float*)(w + track.componentStride),
+			(float*)(w + 2 * track.componentStride), (float*)(w + 3 * track.componentStride) };
+	}
+
+	return view;
+}
+
+// Lays the whole file out in memory and writes it in one go
+bool WriteClipFile(const char* path, const AnimationClip& clip, ClipLayout layout)
+{
+	// A track with no keys can't be evaluated, and MappedClip::Open rejects one, so don't write a file it can't open
+	for (const RotationTrack& rotations : clip.rotations)
+	{
+		if (rotations.keys.empty())
+		{
+			return false;
+		}
+	}
+
+	uint32_t trackCount = (uint32_t)clip.rotations.size();
+	std::vector<ClipFileTrack> tracks(trackCount);
+	uint64_t offset = AlignUp(sizeof(ClipFileHeader) + (uint64_t)trackCount * sizeof(ClipFileTrack));
+
+	for (uint32_t i = 0; i < trackCount; i++)
+	{
+		const RotationTrack& rotations = clip.rotations[i];
+		ClipFileTrack& track = tracks[i];
+		Vector3D t = (i < clip.translations.size()) ? clip.translations[i] : Vector3D(0, 0, 0);
+
+		memset(&track, 0, sizeof(track));
+		track.keyCount = (uint32_t)rotations.keys.size();
+		track.translation[0] = t.x;
+		track.translation[1] = t.y;
+		track.translation[2] = t.z;
+
+		track.timesOffset = offset;
+		offset = AlignUp(offset + track.keyCount * sizeof(float));
+
+		track.keysOffset = offset;
+		if (layout == ClipLayout::AoS)
+		{
+			offset = AlignUp(offset + track.keyCount * sizeof(Quaternion));
+		}
+		else
+		{
+			track.componentStride = (uint32_t)AlignUp(track.keyCount * sizeof(float));
+			offset += 4 * (uint64_t)track.componentStride;
+		}
+	}
+
+	std::vector<char> file((size_t)offset, 0);
+
+	ClipFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CLIP_MAGIC, sizeof(CLIP_MAGIC));
+	header.version = CLIP_VERSION;
+	header.byteOrder = CLIP_BYTE_ORDER;
+	header.trackCount = trackCount;
+	header.layout = (uint32_t)layout;
+	header.fileSize = offset;
+	header.tracksOffset = sizeof(ClipFileHeader);
+
+	memcpy(file.data(), &header, sizeof(header));
+	if (trackCount > 0)
+	{
+		memcpy(file.data() + header.tracksOffset, tracks.data(), trackCount * sizeof(ClipFileTrack));
+	}
+
+	for (uint32_t i = 0; i < trackCount; i++)
+	{
+		const RotationTrack& rotations = clip.rotations[i];
+		const ClipFileTrack& track = tracks[i];
+
+		memcpy(file.data() + track.timesOffset, rotations.times.data(), track.keyCount * sizeof(float));
+
+		if (layout == ClipLayout::AoS)
+		{
+			memcpy(file.data() + track.keysOffset, rotations.keys.data(), track.keyCount * sizeof(Quaternion));
+		}
+		else
+		{
+			float* w = (float*)(file.data() + track.keysOffset);
+			QuaternionSoA soa = { w, w + track.componentStride / sizeof(float),
+				w + 2 * track.componentStride / sizeof(float), w + 3 * track.componentStride / sizeof(float) };
+			ToSoA(rotations.keys.data(), soa, (int)track.keyCount);
+		}
+	}
+
+	FILE* out = fopen(path, "wb");
+	if (out == nullptr)
+	{
+		return false;
+	}
+
+	bool written = fwrite(file.data(), 1, file.size(), out) == file.size();
+	return (fclose(out) == 0) && written;
+}
+
+bool ReadClipText(std::istream& in, AnimationClip& clip)
+{
+	std::string word;
+	int trackCount;
+
+	if (!(in >> word >> trackCount) || word != "clip" || trackCount < 0)
+	{
+		return false;
+	}
+
+	clip.rotations.assign(trackCount, RotationTrack());
+	clip.translations.assign(trackCount, Vector3D(0, 0, 0));
+
+	for (int i = 0; i < trackCount; i++)
+	{
+		int keyCount;
+		Vector3D& t = clip.translations[i];
+
+		if (!(in >> word >> keyCount >> t.x >> t.y >> t.z) || word != "track" || keyCount <= 0)
+		{
+			return false;
+		}
+
+		for (int k = 0; k < keyCount; k++)
+		{
+			float time;
+			Quaternion q;
+
+			if (!(in >> time >> q.w >> q.x >> q.y >> q.z) || (k > 0 && !(time > clip.rotations[i].times.back())))
+			{
+				return false;
+			}
+
+			clip.rotations[i].AddKey(time, q);
+		}
+	}
+
+	return true;
+}
+
+bool ConvertClipText(const char* textPath, const char* clipPath, ClipLayout layout)
+{
+	std::ifstream in(textPath);
+	AnimationClip clip;
+
+	return in && ReadClipText(in, clip) && WriteClipFile(clipPath, clip, layout);
+}
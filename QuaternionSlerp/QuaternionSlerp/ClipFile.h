@@ -0,0 +1,134 @@
+/*
+Title: Quaternion Math
+File Name: ClipFile.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "AnimationTrack.h"
+#include "QuaternionBatch.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+// A binary file of the tracks of an AnimationClip, laid out so that it can be mapped into memory and used as it is,
+//  with no parsing, copying or allocation. Only the pages that are read are loaded, and processes that map the same
+//  file share them. The numbers are stored in the byte order of the machine that wrote the file, and a file from a
+//  machine of the other byte order is rejected.
+//
+// The file is a ClipFileHeader, then trackCount ClipFileTrack entries, then the arrays of each track,
+//  each one starting on a multiple of CLIP_ALIGNMENT bytes from the start of the file:
+//  the keyCount times as floats, then the keys, either as keyCount Quaternions (ClipLayout::AoS)
+//  or as keyCount w, then keyCount x, y and z (ClipLayout::SoA), each of those arrays also aligned.
+// Offsets are in bytes from the start of the file.
+
+static const uint32_t CLIP_VERSION = 1;
+static const uint32_t CLIP_BYTE_ORDER = 0x01020304;
+static const int CLIP_ALIGNMENT = 64;
+
+// How the keys of every track in a file are stored: as Quaternion (for RotationTrack style sampling)
+//  or with each component in its own array (for QuaternionSoA and the batch functions)
+enum class ClipLayout : uint32_t { AoS = 0, SoA = 1 };
+
+struct ClipFileHeader
+{
+	char magic[8];			// "QCLIP" followed by zeros
+	uint32_t version;		// CLIP_VERSION
+	uint32_t byteOrder;		// CLIP_BYTE_ORDER as written by the machine that made the file
+	uint32_t trackCount;
+	uint32_t layout;		// a ClipLayout
+	uint64_t fileSize;
+	uint64_t tracksOffset;	// where the trackCount ClipFileTrack entries start
+	uint8_t reserved[24];
+};
+
+struct ClipFileTrack
+{
+	uint32_t keyCount;
+	uint32_t reserved;
+	uint64_t timesOffset;
+	uint64_t keysOffset;	// the Quaternion array, or the w array with x, y and z following every componentStride bytes
+	float translation[3];	// the joint's translation from its parent, as in AnimationClip
+	uint32_t componentStride;
+};
+
+// One track of a mapped file, pointing straight into the mapping.
+// keys is set for ClipLayout::AoS files and soa for ClipLayout::SoA files, and the other is left null.
+// The mapping is copy-on-write: the arrays can be written, which copies just the pages touched into
+//  this process, and never changes the file.
+struct ClipTrackView
+{
+	int keyCount;
+	const float* times;
+	const Quaternion* keys;
+	QuaternionSoA soa;
+	Vector3D translation;
+
+	// Returns key i whichever layout the file has
+	Quaternion Key(int i) const;
+
+	// Returns the rotation at time t, the same as RotationTrack::Evaluate. The track must have at least one key.
+	Quaternion Evaluate(float t, TrackCursor& cursor) const;
+};
+
+// An animation clip file mapped into memory (with mmap, or MapViewOfFile on Windows).
+// The file stays mapped until Close, which the destructor calls, and the views it hands out are only valid until then.
+class MappedClip
+{
+public:
+	MappedClip();
+	~MappedClip();
+
+	MappedClip(const MappedClip&) = delete;
+	MappedClip& operator=(const MappedClip&) = delete;
+
+	// Maps the file and checks its header and that every track lies inside it.
+	// Returns false, leaving nothing mapped, if the file can't be opened or isn't a valid clip file.
+	bool Open(const char* path);
+	void Close();
+
+	bool IsOpen() const;
+	ClipLayout Layout() const;
+	int TrackCount() const;
+	ClipTrackView Track(int i) const;
+
+private:
+	const ClipFileHeader* Header() const;
+
+	char* data;
+	size_t size;
+#ifdef _WIN32
+	void* file;
+	void* mapping;
+#endif
+};
+
+// Writes the clip to path in the binary format.
+// Returns false, without creating the file, if any track has no keys, and false if the file couldn't be written.
+bool WriteClipFile(const char* path, const AnimationClip& clip, ClipLayout layout = ClipLayout::AoS);
+
+// Reads a clip in the text form, returning false (and leaving clip partly filled in) if it isn't well formed:
+//   clip <trackCount>
+//  then for each track
+//   track <keyCount> <translation x> <y> <z>
+//  followed by keyCount lines of
+//   <time> <w> <x> <y> <z>
+//  with the times increasing. Keys are added with RotationTrack::AddKey, so their signs are lined up.
+bool ReadClipText(std::istream& in, AnimationClip& clip);
+
+// Converts a clip from the text form to the binary format
+bool ConvertClipText(const char* textPath, const char* clipPath, ClipLayout layout = ClipLayout::AoS);
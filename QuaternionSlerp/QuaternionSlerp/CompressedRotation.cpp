@@ -0,0 +1,313 @@
+/*
+Title: Quaternion Math
+File Name: CompressedRotation.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "CompressedRotation.h"
+
+#include <cmath>
+
+constexpr float PackedRotation32::MAX_ANGLE_ERROR;
+constexpr float PackedRotation48::MAX_ANGLE_ERROR;
+
+// The three smallest components lie in [-RANGE, RANGE]
+static const float RANGE = 0.707106781f;
+
+// Samples are interpolated in blocks of this many by Evaluate
+static const int TRACK_BLOCK = 64;
+
+// Finds the largest component, makes it positive, and quantizes the other three to levels 0 to 2^bits - 1.
+static int SmallestThree(Quaternion q, int bits, uint32_t c[3])
+{
+	float v[4] = { q.w, q.x, q.y, q.z };
+	int largest = 0;
+
+	for (int i = 1; i < 4; i++)
+	{
+		if (std::abs(v[i]) > std::abs(v[largest]))
+		{
+			largest = i;
+		}
+	}
+
+	float sign = (v[largest] < 0) ? -1.0f : 1.0f;
+	float levels = (float)((1 << bits) - 1);
+
+	for (int i = 0, k = 0; i < 4; i++)
+	{
+		if (i != largest)
+		{
+			float u = (sign * v[i] + RANGE) / (2 * RANGE) * levels + 0.5f;
+			u = (u < 0) ? 0 : (u > levels) ? levels : u;
+			c[k++] = (uint32_t)u;
+		}
+	}
+
+	return largest;
+}
+
+PackedRotation32 PackRotation32(Quaternion q) noexcept
+{
+	uint32_t c[3];
+	uint32_t largest = (uint32_t)SmallestThree(q, PackedRotation32::COMPONENT_BITS, c);
+
+	PackedRotation32 p;
+	p.bits = (largest << 30) | (c[0] << 20) | (c[1] << 10) | c[2];
+	return p;
+}
+
+PackedRotation48 PackRotation48(Quaternion q) noexcept
+{
+	uint32_t c[3];
+	uint32_t largest = (uint32_t)SmallestThree(q, PackedRotation48::COMPONENT_BITS, c);
+
+	PackedRotation48 p;
+	p.bits[0] = (uint16_t)(((largest & 1) << 15) | c[0]);
+	p.bits[1] = (uint16_t)(((largest >> 1) << 15) | c[1]);
+	p.bits[2] = (uint16_t)c[2];
+	return p;
+}
+
+// Turns the left out component and the three stored ones back into a quaternion.
+// The components are put in place by multiplying with 0 or 1 flags rather than by indexing or selects,
+//  which GCC turns back into branches here, so that the batch loops below are vectorized.
+static void Rebuild(int largest, float a, float b, float c, float& w, float& x, float& y, float& z)
+{
+	float s = 1 - a * a - b * b - c * c;
+	float d = std::sqrt((s > 0) ? s : 0);
+
+	float is0 = (float)(largest == 0), is1 = (float)(largest == 1), is2 = (float)(largest == 2), is3 = (float)(largest == 3);
+
+	w = a + is0 * (d - a);
+	x = b + is0 * (a - b) + is1 * (d - b);
+	y = c + (is0 + is1) * (b - c) + is2 * (d - c);
+	z = d + (1 - is3) * (c - d);
+}
+
+Quaternion Unpack(PackedRotation32 p) noexcept
+{
+	Quaternion q;
+	UnpackRotations(&p, QuaternionSoA{ &q.w, &q.x, &q.y, &q.z }, 1);
+	return q;
+}
+
+Quaternion Unpack(PackedRotation48 p) noexcept
+{
+	Quaternion q;
+	UnpackRotations(&p, QuaternionSoA{ &q.w, &q.x, &q.y, &q.z }, 1);
+	return q;
+}
+
+void UnpackRotations(const PackedRotation32* p, QuaternionSoA out, int count)
+{
+	const float scale = 2 * RANGE / 1023;
+
+	for (int i = 0; i < count; i++)
+	{
+		uint32_t bits = p[i].bits;
+		int largest = (int)(bits >> 30);
+		float a = (float)(int)((bits >> 20) & 1023) * scale - RANGE;
+		float b = (float)(int)((bits >> 10) & 1023) * scale - RANGE;
+		float c = (float)(int)(bits & 1023) * scale - RANGE;
+
+		Rebuild(largest, a, b, c, out.w[i], out.x[i], out.y[i], out.z[i]);
+	}
+}
+
+// The 16 bit words are widened into local arrays first: GCC won't vectorize a loop that reads them
+//  and writes floats directly.
+void UnpackRotations(const PackedRotation48* p, QuaternionSoA out, int count)
+{
+	const float scale = 2 * RANGE / 32767;
+	int b0[TRACK_BLOCK], b1[TRACK_BLOCK], b2[TRACK_BLOCK];
+
+	for (int start = 0; start < count; start += TRACK_BLOCK)
+	{
+		int n = (count - start < TRACK_BLOCK) ? count - start : TRACK_BLOCK;
+
+		for (int i = 0; i < n; i++)
+		{
+			b0[i] = p[start + i].bits[0];
+			b1[i] = p[start + i].bits[1];
+			b2[i] = p[start + i].bits[2];
+		}
+
+		for (int i = 0; i < n; i++)
+		{
+			int largest = (b0[i] >> 15) | ((b1[i] >> 14) & 2);
+			float a = (float)(b0[i] & 32767) * scale - RANGE;
+			float b = (float)(b1[i] & 32767) * scale - RANGE;
+			float c = (float)b2[i] * scale - RANGE;
+
+			Rebuild(largest, a, b, c, out.w[start + i], out.x[start + i], out.y[start + i], out.z[start + i]);
+		}
+	}
+}
+
+static PackedRotation32 Pack(Quaternion q, PackedRotation32)
+{
+	return PackRotation32(q);
+}
+
+static PackedRotation48 Pack(Quaternion q, PackedRotation48)
+{
+	return PackRotation48(q);
+}
+
+static const int MAX_TICK = 65535;
+
+template <typename Packed>
+CompressedRotationTrack<Packed>::CompressedRotationTrack(const RotationTrack& track)
+	: startTime(0), tickLength(1)
+{
+	int count = (int)track.times.size();
+
+	if (count > 1)
+	{
+		startTime = track.times.front();
+		tickLength = (track.times.back() - startTime) / MAX_TICK;
+	}
+
+	// Round each time to the nearest tick, then push apart any keys that landed on the same tick.
+	// Pushing forward from the first tick and back from the last one keeps the ticks increasing and in range.
+	ticks.resize(count);
+	for (int i = 0; i < count; i++)
+	{
+		int tick = (int)std::lround((track.times[i] - startTime) / tickLength);
+		tick = (i > 0 && tick <= ticks[i - 1]) ? ticks[i - 1] + 1 : tick;
+		ticks[i] = (uint16_t)((tick < MAX_TICK) ? tick : MAX_TICK);
+	}
+	for (int i = count - 2; i >= 0; i--)
+	{
+		ticks[i] = (ticks[i] < ticks[i + 1]) ? ticks[i] : (uint16_t)(ticks[i + 1] - 1);
+	}
+
+	keys.reserve(track.keys.size());
+	for (Quaternion q : track.keys)
+	{
+		keys.push_back(Pack(q, Packed()));
+	}
+}
+
+template <typename Packed>
+float CompressedRotationTrack<Packed>::KeyTime(int i) const
+{
+	return startTime + ticks[i] * tickLength;
+}
+
+template <typename Packed>
+Quaternion CompressedRotationTrack<Packed>::Evaluate(float t, TrackCursor& cursor) const
+{
+	int count = (int)ticks.size();
+	float tick = (t - startTime) / tickLength;
+	int segment = FindSegment(ticks.data(), count, tick, cursor);
+
+	if (tick <= ticks[segment])
+	{
+		return Unpack(keys[segment]);
+	}
+	if (segment + 1 >= count || tick >= ticks[segment + 1])
+	{
+		return Unpack(keys[(segment + 1 < count) ? segment + 1 : segment]);
+	}
+
+	Quaternion a = Unpack(keys[segment]);
+	Quaternion b = Unpack(keys[segment + 1]);
+	return Slerp(a, (Dot(a, b) < 0) ? -b : b, SegmentFraction(ticks.data(), count, segment, tick));
+}
+
+// Samples close together in time share keys, so when a block of samples spans few enough keys,
+//  those keys are unpacked once and then copied to each sample, instead of unpacking two keys per sample.
+template <typename Packed>
+void CompressedRotationTrack<Packed>::Evaluate(const float* t, Quaternion* out, int count) const
+{
+	Packed pa[TRACK_BLOCK], pb[TRACK_BLOCK];
+	int first[TRACK_BLOCK], second[TRACK_BLOCK];
+	float kw[TRACK_BLOCK], kx[TRACK_BLOCK], ky[TRACK_BLOCK], kz[TRACK_BLOCK];
+	float aw[TRACK_BLOCK], ax[TRACK_BLOCK], ay[TRACK_BLOCK], az[TRACK_BLOCK];
+	float bw[TRACK_BLOCK], bx[TRACK_BLOCK], by[TRACK_BLOCK], bz[TRACK_BLOCK];
+	float ow[TRACK_BLOCK], ox[TRACK_BLOCK], oy[TRACK_BLOCK], oz[TRACK_BLOCK];
+	float u[TRACK_BLOCK];
+	QuaternionSoA k = { kw, kx, ky, kz };
+	QuaternionSoA a = { aw, ax, ay, az };
+	QuaternionSoA b = { bw, bx, by, bz };
+	QuaternionSoA o = { ow, ox, oy, oz };
+	TrackCursor cursor;
+	int keyCount = (int)keys.size();
+
+	for (int start = 0; start < count; start += TRACK_BLOCK)
+	{
+		int n = (count - start < TRACK_BLOCK) ? count - start : TRACK_BLOCK;
+		int lowest = keyCount, highest = 0;
+
+		for (int i = 0; i < n; i++)
+		{
+			float tick = (t[start + i] - startTime) / tickLength;
+			int segment = FindSegment(ticks.data(), keyCount, tick, cursor);
+			first[i] = segment;
+			second[i] = (segment + 1 < keyCount) ? segment + 1 : segment;
+			u[i] = SegmentFraction(ticks.data(), keyCount, segment, tick);
+
+			lowest = (first[i] < lowest) ? first[i] : lowest;
+			highest = (second[i] > highest) ? second[i] : highest;
+		}
+
+		if (highest - lowest < TRACK_BLOCK)
+		{
+			UnpackRotations(keys.data() + lowest, k, highest - lowest + 1);
+
+			for (int i = 0; i < n; i++)
+			{
+				int ka = first[i] - lowest, kb = second[i] - lowest;
+				aw[i] = kw[ka]; ax[i] = kx[ka]; ay[i] = ky[ka]; az[i] = kz[ka];
+				bw[i] = kw[kb]; bx[i] = kx[kb]; by[i] = ky[kb]; bz[i] = kz[kb];
+			}
+		}
+		else
+		{
+			for (int i = 0; i < n; i++)
+			{
+				pa[i] = keys[first[i]];
+				pb[i] = keys[second[i]];
+			}
+
+			UnpackRotations(pa, a, n);
+			UnpackRotations(pb, b, n);
+		}
+
+		// Put b on the same side as a, so that Slerp takes the shorter way
+		for (int i = 0; i < n; i++)
+		{
+			float s = (aw[i] * bw[i] + ax[i] * bx[i] + ay[i] * by[i] + az[i] * bz[i] < 0) ? -1.0f : 1.0f;
+			bw[i] *= s;
+			bx[i] *= s;
+			by[i] *= s;
+			bz[i] *= s;
+		}
+
+		SlerpBatch(a, b, u, o, n);
+		FromSoA(o, out + start, n);
+	}
+}
+
+template <typename Packed>
+size_t CompressedRotationTrack<Packed>::MemorySize() const
+{
+	return sizeof(startTime) + sizeof(tickLength) + ticks.size() * sizeof(uint16_t) + keys.size() * sizeof(Packed);
+}
+
+template struct CompressedRotationTrack<PackedRotation32>;
+template struct CompressedRotationTrack<PackedRotation48>;
@@ -0,0 +1,99 @@
+/*
+Title: Quaternion Math
+File Name: CompressedRotation.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "AnimationTrack.h"
+#include "QuaternionBatch.h"
+
+#include <cstdint>
+#include <vector>
+
+// Unit quaternions packed with the "smallest three" method.
+// The largest component (by magnitude) of a unit quaternion is at least 1/2, and the other three lie in
+//  [-1/sqrt(2), 1/sqrt(2)]. Since q and -q are the same rotation, the largest one can be made positive and then left out,
+//  to be worked out again as sqrt(1 - a^2 - b^2 - c^2). So the packing stores which component was left out (2 bits)
+//  and the other three quantized evenly over [-1/sqrt(2), 1/sqrt(2)].
+// Unpacking always gives the quaternion with the largest component positive, which may be the negative of the one packed.
+// MAX_ANGLE_ERROR is the largest angle, in radians, between the rotations before and after packing,
+//  measured over 10M random unit quaternions.
+
+// 32 bits: 10 bits per component, 4x smaller than a Quaternion. Max error 0.25 degrees.
+struct PackedRotation32
+{
+	static const int COMPONENT_BITS = 10;
+	static constexpr float MAX_ANGLE_ERROR = 4.3e-3f;
+
+	// The index in the top 2 bits, then the three components from the highest bits down
+	uint32_t bits;
+};
+
+// 48 bits: 15 bits per component, 2.67x smaller than a Quaternion. Max error 0.008 degrees.
+struct PackedRotation48
+{
+	static const int COMPONENT_BITS = 15;
+	static constexpr float MAX_ANGLE_ERROR = 1.4e-4f;
+
+	// One component in the low 15 bits of each word, and the index split over the top bits of the first two
+	uint16_t bits[3];
+};
+
+PackedRotation32 PackRotation32(Quaternion q) noexcept;
+PackedRotation48 PackRotation48(Quaternion q) noexcept;
+Quaternion Unpack(PackedRotation32 p) noexcept;
+Quaternion Unpack(PackedRotation48 p) noexcept;
+
+// Unpacks count quaternions into SoA arrays. The loops have no branches and are vectorized.
+void UnpackRotations(const PackedRotation32* p, QuaternionSoA out, int count);
+void UnpackRotations(const PackedRotation48* p, QuaternionSoA out, int count);
+
+// A RotationTrack with its keys packed as PackedRotation32 or PackedRotation48, and its times as 16-bit ticks.
+// The ticks split the span from the first key to the last into 65535 steps, so every time moves by at most half
+//  a tick, 1/131070 of the track's length, and the rotation by at most that times its angular speed: about
+//  0.03 degrees for a 10 second track turning at 360 degrees a second. Keys closer together than a tick
+//  are moved a tick apart. The track can have at most 65536 keys.
+// At 6 bytes per key the 32-bit track is 3.3x smaller than the RotationTrack it was made from, and at 8 bytes
+//  the 48-bit one is 2.5x smaller.
+// Sampling unpacks the two keys around each time straight into the SoA arrays that SlerpBatch reads,
+//  lining their signs up first, since packing may have flipped either of them.
+template <typename Packed>
+struct CompressedRotationTrack
+{
+	// The time of key i is startTime + ticks[i] * tickLength
+	float startTime;
+	float tickLength;
+	std::vector<uint16_t> ticks;
+	std::vector<Packed> keys;
+
+	CompressedRotationTrack() : startTime(0), tickLength(1) {}
+	explicit CompressedRotationTrack(const RotationTrack& track);
+
+	// Returns the time of key i, after rounding to a tick
+	float KeyTime(int i) const;
+
+	// Returns the rotation at time t, as RotationTrack::Evaluate does. The track must have at least one key.
+	Quaternion Evaluate(float t, TrackCursor& cursor) const;
+	// Samples the track at count times: out[i] = Evaluate(t[i]).
+	void Evaluate(const float* t, Quaternion* out, int count) const;
+
+	// The bytes used by the times and keys
+	size_t MemorySize() const;
+};
+
+typedef CompressedRotationTrack<PackedRotation32> CompressedRotationTrack32;
+typedef CompressedRotationTrack<PackedRotation48> CompressedRotationTrack48;
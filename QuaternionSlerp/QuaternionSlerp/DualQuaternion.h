@@ -0,0 +1,137 @@
+/*
+Title: Quaternion Math
+File Name: DualQuaternion.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "Quaternion.h"
+#include "Matrix4D.h"
+
+#include <iostream>
+
+// A dual quaternion real + e * dual, where e * e = 0, represents a rigid transform (a rotation and then a translation)
+//  in 8 numbers instead of the 12 or 16 of a matrix.
+// For the rotation q and translation t, real = q and dual = (0, t) * q / 2.
+// Multiplying dual quaternions composes their transforms the same way as multiplying matrices:
+//  (a * b) applies b first and then a.
+// Unlike matrices, weighted sums of unit dual quaternions stay close to rigid transforms once normalized,
+//  which is what makes them good for blending bones in skinning (see Skinning.h).
+struct DualQuaternion
+{
+	Quaternion real, dual;
+
+	constexpr DualQuaternion() noexcept;
+	constexpr DualQuaternion(Quaternion real, Quaternion dual) noexcept;
+};
+
+// Returns the dual quaternion for rotating by the unit quaternion q and then translating by t
+constexpr DualQuaternion MakeDualQuaternion(Quaternion q, Vector3D t) noexcept;
+
+constexpr DualQuaternion operator+(const DualQuaternion& l, const DualQuaternion& r) noexcept;
+constexpr DualQuaternion operator-(const DualQuaternion& d) noexcept;
+constexpr DualQuaternion operator*(float s, const DualQuaternion& d) noexcept;
+constexpr DualQuaternion operator*(const DualQuaternion& d, float s) noexcept;
+constexpr DualQuaternion operator*(const DualQuaternion& l, const DualQuaternion& r) noexcept;
+
+// Conjugates both parts. For a unit dual quaternion this is the inverse transform.
+constexpr DualQuaternion Conjugate(const DualQuaternion& d) noexcept;
+
+// The rotation and translation of a unit dual quaternion
+constexpr Quaternion GetRotation(const DualQuaternion& d) noexcept;
+constexpr Vector3D GetTranslation(const DualQuaternion& d) noexcept;
+
+// Rotates and then translates a point. d must be a unit dual quaternion.
+constexpr Vector3D TransformPoint(const DualQuaternion& d, Vector3D p) noexcept;
+
+// Divides by the magnitude of the real part, which makes it a unit dual quaternion again after blending.
+DualQuaternion Normalize(const DualQuaternion& d) noexcept;
+
+// Converts between unit dual quaternions and rigid transform matrices.
+// m must be rigid (see Classify in Matrix4D.h); any scale in it is lost.
+DualQuaternion ToDualQuaternion(const Matrix4D& m) noexcept;
+Matrix4D TransformMatrix(const DualQuaternion& d) noexcept;
+
+std::ostream& operator<<(std::ostream& os, const DualQuaternion& d);
+
+// The constexpr functions are defined here so that they can be evaluated at compile time.
+
+constexpr DualQuaternion::DualQuaternion() noexcept
+	: real(1, 0, 0, 0), dual(0, 0, 0, 0)
+{
+}
+
+constexpr DualQuaternion::DualQuaternion(Quaternion real, Quaternion dual) noexcept
+	: real(real), dual(dual)
+{
+}
+
+constexpr DualQuaternion MakeDualQuaternion(Quaternion q, Vector3D t) noexcept
+{
+	return DualQuaternion(q, 0.5f * (Quaternion(0, t) * q));
+}
+
+constexpr DualQuaternion operator+(const DualQuaternion& l, const DualQuaternion& r) noexcept
+{
+	return DualQuaternion(l.real + r.real, l.dual + r.dual);
+}
+
+constexpr DualQuaternion operator-(const DualQuaternion& d) noexcept
+{
+	return DualQuaternion(-d.real, -d.dual);
+}
+
+constexpr DualQuaternion operator*(float s, const DualQuaternion& d) noexcept
+{
+	return DualQuaternion(s * d.real, s * d.dual);
+}
+
+constexpr DualQuaternion operator*(const DualQuaternion& d, float s) noexcept
+{
+	return s * d;
+}
+
+// (a + e b)(c + e d) = ac + e(ad + bc), since e * e = 0
+constexpr DualQuaternion operator*(const DualQuaternion& l, const DualQuaternion& r) noexcept
+{
+	return DualQuaternion(l.real * r.real, l.real * r.dual + l.dual * r.real);
+}
+
+constexpr DualQuaternion Conjugate(const DualQuaternion& d) noexcept
+{
+	return DualQuaternion(Conjugate(d.real), Conjugate(d.dual));
+}
+
+constexpr Quaternion GetRotation(const DualQuaternion& d) noexcept
+{
+	return d.real;
+}
+
+// dual = (0, t) * real / 2, so (0, t) = 2 * dual * Conjugate(real)
+constexpr Vector3D GetTranslation(const DualQuaternion& d) noexcept
+{
+	Quaternion t = 2.0f * (d.dual * Conjugate(d.real));
+	return Vector3D(t.x, t.y, t.z);
+}
+
+constexpr Vector3D TransformPoint(const DualQuaternion& d, Vector3D p) noexcept
+{
+	return RotateVector(p, d.real) + GetTranslation(d);
+}
+
+#ifdef MATH_HEADER_ONLY
+#include "DualQuaternion.inl"
+#endif
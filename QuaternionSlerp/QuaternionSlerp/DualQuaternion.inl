@@ -0,0 +1,48 @@
+/*
+Title: Quaternion Math
+File Name: DualQuaternion.inl
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Definitions of the functions declared in DualQuaternion.h (see MATH_HEADER_ONLY in helpers.h).
+#pragma once
+
+MATH_INLINE DualQuaternion Normalize(const DualQuaternion& d) noexcept
+{
+	float invLength = 1.0f / Magnitude(d.real);
+	return DualQuaternion(d.real * invLength, d.dual * invLength);
+}
+
+MATH_INLINE DualQuaternion ToDualQuaternion(const Matrix4D& m) noexcept
+{
+	return MakeDualQuaternion(Rotation(m), Vector3D(m(0, 3), m(1, 3), m(2, 3)));
+}
+
+MATH_INLINE Matrix4D TransformMatrix(const DualQuaternion& d) noexcept
+{
+	Matrix3D r = RotationMatrix(d.real);
+	Vector3D t = GetTranslation(d);
+
+	return Matrix4D(r(0, 0), r(0, 1), r(0, 2), t.x,
+		r(1, 0), r(1, 1), r(1, 2), t.y,
+		r(2, 0), r(2, 1), r(2, 2), t.z,
+		0, 0, 0, 1);
+}
+
+MATH_INLINE std::ostream& operator<<(std::ostream& os, const DualQuaternion& d)
+{
+	os << "(" << d.real << ", " << d.dual << ")";
+	return os;
+}
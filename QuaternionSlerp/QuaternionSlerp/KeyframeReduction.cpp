@@ -0,0 +1,151 @@
+/*
+Title: Quaternion Math
+File Name: KeyframeReduction.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "KeyframeReduction.h"
+#include "Parallel.h"
+
+#include <cmath>
+#include <vector>
+
+double ReductionReport::CompressionRatio() const
+{
+	return (keysAfter > 0) ? (double)keysBefore / (double)keysAfter : 1.0;
+}
+
+double KeyError(Quaternion q, Quaternion r) noexcept
+{
+	double dot = (double)q.w * r.w + (double)q.x * r.x + (double)q.y * r.y + (double)q.z * r.z;
+	double norms = std::sqrt(((double)q.w * q.w + (double)q.x * q.x + (double)q.y * q.y + (double)q.z * q.z)
+		* ((double)r.w * r.w + (double)r.x * r.x + (double)r.y * r.y + (double)r.z * r.z));
+	double c = std::fabs(dot) / norms;
+
+	return std::acos((c < 1) ? c : 1);
+}
+
+// Returns the largest error of rebuilding keys first + 1 to last - 1 by Slerp between first and last,
+//  stopping early once it is over tolerance. last is flipped to the same side as first,
+//  the same as RotationTrack::AddKey does when the reduced track is built.
+static double SpanError(const RotationTrack& track, int first, int last, double tolerance)
+{
+	Quaternion a = track.keys[first];
+	Quaternion b = (Dot(a, track.keys[last]) < 0) ? -track.keys[last] : track.keys[last];
+	float t0 = track.times[first], t1 = track.times[last];
+	double worst = 0;
+
+	for (int k = first + 1; k < last && worst <= tolerance; k++)
+	{
+		double error = KeyError(Slerp(a, b, (track.times[k] - t0) / (t1 - t0)), track.keys[k]);
+		worst = (error > worst) ? error : worst;
+	}
+
+	return worst;
+}
+
+RotationTrack ReduceKeys(const RotationTrack& track, double tolerance, ReductionReport* report)
+{
+	RotationTrack reduced;
+	int count = (int)track.keys.size();
+	double maxError = 0;
+
+	if (count > 0)
+	{
+		reduced.AddKey(track.times[0], track.keys[0]);
+	}
+
+	int kept = 0;
+	while (kept < count - 1)
+	{
+		// Find how far the span from kept can reach. The span to kept + 1 has nothing to rebuild, so it always does.
+		// Double the span until one can't be rebuilt (or the track ends), then binary search between the longest
+		//  span that could and the shortest that couldn't. Each try costs as many Slerps as its span is long,
+		//  so a span of length m costs O(m log m) instead of the O(m^2) of trying one key longer each time.
+		int good = kept + 1, bad = count;
+		double goodError = 0;
+
+		for (int span = 2; ; span *= 2)
+		{
+			int last = (kept + span < count) ? kept + span : count - 1;
+			if (last <= good)
+			{
+				break;
+			}
+
+			double error = SpanError(track, kept, last, tolerance);
+			if (error > tolerance)
+			{
+				bad = last;
+				break;
+			}
+
+			good = last;
+			goodError = error;
+		}
+
+		while (bad - good > 1)
+		{
+			int middle = good + (bad - good) / 2;
+			double error = SpanError(track, kept, middle, tolerance);
+			if (error > tolerance)
+			{
+				bad = middle;
+			}
+			else
+			{
+				good = middle;
+				goodError = error;
+			}
+		}
+
+		reduced.AddKey(track.times[good], track.keys[good]);
+		maxError = (goodError > maxError) ? goodError : maxError;
+		kept = good;
+	}
+
+	if (report != nullptr)
+	{
+		report->keysBefore = count;
+		report->keysAfter = (long long)reduced.keys.size();
+		report->maxError = maxError;
+	}
+
+	return reduced;
+}
+
+ReductionReport ReduceKeys(const RotationTrack* in, RotationTrack* out, int count, double tolerance, int threads)
+{
+	std::vector<ReductionReport> reports(count);
+	ReductionReport* r = reports.data();
+
+	ParallelFor(count, threads, 1, [=](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			out[i] = ReduceKeys(in[i], tolerance, r + i);
+		}
+	});
+
+	ReductionReport total;
+	for (const ReductionReport& report : reports)
+	{
+		total.keysBefore += report.keysBefore;
+		total.keysAfter += report.keysAfter;
+		total.maxError = (report.maxError > total.maxError) ? report.maxError : total.maxError;
+	}
+
+	return total;
+}
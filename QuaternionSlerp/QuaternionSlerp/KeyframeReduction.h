@@ -0,0 +1,52 @@
+/*
+Title: Quaternion Math
+File Name: KeyframeReduction.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "AnimationTrack.h"
+
+// What a reduction did: how many keys there were before and after, and the largest error it allowed.
+struct ReductionReport
+{
+	long long keysBefore;
+	long long keysAfter;
+	double maxError;
+
+	ReductionReport() : keysBefore(0), keysAfter(0), maxError(0) {}
+
+	// How many times fewer keys there are, keysBefore / keysAfter
+	double CompressionRatio() const;
+};
+
+// The angle between two quaternions, as AngleBetweenQuaternions, but the same for q and -q (which are the same rotation)
+//  and worked out in double, since the float acos of a dot product near 1 can't resolve angles under about 1e-3.
+// The rotations themselves differ by twice this angle.
+double KeyError(Quaternion q, Quaternion r) noexcept;
+
+// Removes the keys of a track that Slerp between the keys kept around them reproduces to within tolerance,
+//  measured with KeyError, at the time of every removed key. The first and last keys are always kept.
+// Works forward from each kept key, skipping as many keys as it can before the next one has to be kept.
+// The next key is found by doubling the span and then a binary search, so a track of n keys takes O(n log n) Slerps.
+// The error of a span doesn't always grow with its length, so this may keep a key that trying every span would
+//  have skipped, but every span it keeps is within tolerance.
+// report (if it isn't nullptr) is filled in for this track.
+RotationTrack ReduceKeys(const RotationTrack& track, double tolerance, ReductionReport* report = nullptr);
+
+// Reduces count tracks, out[i] = ReduceKeys(in[i], tolerance), and returns the totals over all of them.
+// The tracks are split across up to threads threads (0 for one per hardware thread, see ParallelFor).
+ReductionReport ReduceKeys(const RotationTrack* in, RotationTrack* out, int count, double tolerance, int threads = 1);
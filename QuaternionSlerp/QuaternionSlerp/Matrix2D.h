@@ -25,122 +25,131 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <iostream>
 #include <cmath>
 
+// The components of a Vector2D in order, so that operator() can pick component i of a column without branching on i.
+constexpr float Vector2D::* VECTOR2D_COMPONENTS[2] = { &Vector2D::x, &Vector2D::y };
+
 // A 2x2 matrix of floats.
 struct Matrix2D
 {
 private:
-	// Our 4 values in a 2-by-2 grid.
-	float n[2][2];
+	// Our 4 values, held as 2 column vectors.
+	Vector2D columns[2];
 	// N.B. that we have chosen to hold these values in column-major order,
 	//   which is why this is private (or else it is very easy to reverse the row-column order when reading).
 	// By column-major, we mean that as memory increases linearly, the matrix is actually read down columns first, then rows.
 	// So for example the linear memory would look something like this:
-	//   -----+---------------------------------------+-----
-	//    ... | n[0][0] | n[0][1] | n[1][0] | n[1][1] | ...
-	//   -----+---------------------------------------+-----
+	//   -----+-----------------------------------------------------------+-----
+	//    ... | columns[0].x | columns[0].y | columns[1].x | columns[1].y | ...
+	//   -----+-----------------------------------------------------------+-----
 	// While actually representing the matrix
-	//   [ n[0][0] n[1][0] ]
-	//   [ n[0][1] n[1][1] ]
+	//   [ columns[0].x columns[1].x ]
+	//   [ columns[0].y columns[1].y ]
 	// (Even though by convention in mathematical literature, when referencing a matrix element, we say the row first, then the column.)
+	// Holding real Vector2D objects, rather than floats, is what lets operator[] hand out a reference to a column.
+	// Treating an array of floats as if it were a Vector2D breaks C++'s aliasing rules, and the optimizer may then
+	//  reorder reads and writes of the same element.
 
 public:
 	// The default constructor returns the Identity matrix (1s along the diagonal, 0s everywhere else)
-	Matrix2D();
+	Matrix2D() noexcept;
 	// We have chosen the multiplicative identity instead of the additive identity because matrix addition is used less commonly than multiplication.
 
 	// Sets the nij-th element of the matrix
 	Matrix2D(float n00, float n01,
-		float n10, float n11);
+		float n10, float n11) noexcept;
 
 	// Sets the first column to a and the second to b
-	Matrix2D(Vector2D a, Vector2D b);
+	Matrix2D(Vector2D a, Vector2D b) noexcept;
 
 	// Returns a reference to nij (i.e., the element at row i, column j)
-	float& operator()(int i, int j);
+	float& operator()(int i, int j) noexcept;
+	const float& operator()(int i, int j) const noexcept;
 
 	// Returns a reference to column j
-	Vector2D& operator[](int j);
+	Vector2D& operator[](int j) noexcept;
+	const Vector2D& operator[](int j) const noexcept;
 
 	// Returns a new Vector2D that is row i
-	Vector2D row(int i);
+	Vector2D row(int i) const noexcept;
 	// Note that we cannot return a reference because row values are not neighbors in memory,
 	//  so we must copy the values
 
 	// Returns a reference to column j (alias for [])
-	Vector2D& col(int j);
+	Vector2D& col(int j) noexcept;
+	const Vector2D& col(int j) const noexcept;
 };
 
 // Negates the matrix m
-Matrix2D operator-(Matrix2D m);
+Matrix2D operator-(const Matrix2D& m) noexcept;
 
 // Uniformly scales all elements of m by s and returns the new matrix
-Matrix2D operator*(float s, Matrix2D m);
+Matrix2D operator*(float s, const Matrix2D& m) noexcept;
 
 // Alias for s * m (scalar multiplication is commutative)
-Matrix2D operator*(Matrix2D m, float s);
+Matrix2D operator*(const Matrix2D& m, float s) noexcept;
 
 // Divides each element of m by s
-Matrix2D operator/(Matrix2D m, float s);
+Matrix2D operator/(const Matrix2D& m, float s) noexcept;
 
 // Returns the matrix sum of l and r. This operation will not be commonly used.
 // This operation is commutative.
-Matrix2D operator+(Matrix2D l, Matrix2D r);
+Matrix2D operator+(const Matrix2D& l, const Matrix2D& r) noexcept;
 
 // Subracts matrix r from matrix l.
-Matrix2D operator-(Matrix2D l, Matrix2D r);
+Matrix2D operator-(const Matrix2D& l, const Matrix2D& r) noexcept;
 
 // Returns the matrix product of l and r.
 // This operation is NOT commutative!
-Matrix2D operator*(Matrix2D l, Matrix2D r);
+Matrix2D operator*(const Matrix2D& l, const Matrix2D& r) noexcept;
 
 // Returns the product of m and v (as a column vector).
-Vector2D operator*(Matrix2D m, Vector2D v);
+Vector2D operator*(const Matrix2D& m, Vector2D v) noexcept;
 
 // Returns the product of v (as a row vector) and m.
-Vector2D operator*(Vector2D v, Matrix2D m);
+Vector2D operator*(Vector2D v, const Matrix2D& m) noexcept;
 
 // Compares l and r. Returns true if l and r are equal.
-bool operator==(Matrix2D l, Matrix2D r);
+bool operator==(const Matrix2D& l, const Matrix2D& r) noexcept;
 
 // Negation of ==
-bool operator!=(Matrix2D l, Matrix2D r);
+bool operator!=(const Matrix2D& l, const Matrix2D& r) noexcept;
 
 // Returns the determinant of m (the area of the parallelogram with sides m[0] and m[1]).
-float Determinant(Matrix2D m);
+float Determinant(const Matrix2D& m) noexcept;
 
 // Returns the inverse of m.
 // The inverse of a matrix is the unique matrix such that Inverse(m) * m = m * Inverse(m) = I,
 //  where I is the identity matrix.
-Matrix2D Inverse(Matrix2D m);
+Matrix2D Inverse(const Matrix2D& m) noexcept;
 
 // Returns the inverse of m, calculated slightly differently.
-Matrix2D InverseAdj(Matrix2D m);
+Matrix2D InverseAdj(const Matrix2D& m) noexcept;
 // For 2x2 matrices, Inverse and InverseAdj are roughly the same speed (based on experimental testing).
 
 // The minor of a matrix at row i, column j, is an (n-1) by (n-1) matrix that excludes row i and column j.
-float Minor(Matrix2D m, int i, int j);
+float Minor(const Matrix2D& m, int i, int j) noexcept;
 // Note that the minor has the same order as the original matrix (i.e., the rows and columns are not permuted in any way,
 //  which is why we cannot use modular arithmetic to calculate minors).
 
 // The Cofactor of m at row i, column j, is the Determinant of Minor(m, i, j) times -1 if i + j is odd or 1 if i + j is even.
-float Cofactor(Matrix2D m, int i, int j);
+float Cofactor(const Matrix2D& m, int i, int j) noexcept;
 
 // The Cofactor Matrix C of a matrix m is an n by n matrix where each element C(i, j) is the Cofactor of m at (i, j)
-Matrix2D CofactorMatrix(Matrix2D m);
+Matrix2D CofactorMatrix(const Matrix2D& m) noexcept;
 
 // The Adjugate of m is simply the transpose of the Cofactor Matrix.
 // It has the unique property that adj(m) = det(m)*Inverse(m)
-Matrix2D Adjugate(Matrix2D m);
+Matrix2D Adjugate(const Matrix2D& m) noexcept;
 
 // The Transpose of a matrix m, mT, is the matrix achieved by swapping off-diagonal elements.
 // Formally, Transpose(m)(i,j) = m(j, i)
-Matrix2D Transpose(Matrix2D m);
+Matrix2D Transpose(const Matrix2D& m) noexcept;
 
 // The Outer product of two vectors is equivalent to the matrix product of a (as a column vector) and b (as a row vector).
 // If a is an n-dimensional vector and b is an m-dimensional vector, then a * b is an nx1 matrix times a 1xm matrix,
 // so the result is an nxm matrix.
 // Alternatively, if a and b are both considered as column vectors, then Outer(a, b) = a * Transpose(b)
-Matrix2D Outer(Vector2D a, Vector2D b);
+Matrix2D Outer(Vector2D a, Vector2D b) noexcept;
 
 // Returns the outer product of b with itself, divided by the magnitude of b squared.
 // Equivalently, the outer product of Normalize(b) with itself.
@@ -148,19 +157,23 @@ Matrix2D Outer(Vector2D a, Vector2D b);
 //  as the projection matrix can only be calculated once then re-used.
 // Note that for only one projection, this is actually less efficient.
 // Usage: Given two vectors a, and b, Project(a, b) = MakeProjection(b) * a
-Matrix2D MakeProjection(Vector2D b);
+Matrix2D MakeProjection(Vector2D b) noexcept;
 
 // Returns the identity minus MakeProjection(b).
 // Useful to reject many vectors from one.
 // Similar to MakeProjection, Reject(a, b) = MakeRejection(b) * a
-Matrix2D MakeRejection(Vector2D b);
+Matrix2D MakeRejection(Vector2D b) noexcept;
 
 // Returns the 2D rotation matrix corresponding to a counter-clockwise rotation by theta radians.
-Matrix2D MakeRotation(float theta);
+Matrix2D MakeRotation(float theta) noexcept;
 
 // Returns a 2D matrix that is the reflection of the provided matrix (along x-axis, y-axis, origin, line x = y)
-Matrix2D ReflectMatrix(Matrix2D m, Matrix2D reflectionMatrix);
+Matrix2D ReflectMatrix(const Matrix2D& m, const Matrix2D& reflectionMatrix) noexcept;
 
 // A simple << operator for use with std::cout.
 // Note that it ends with a newline.
-std::ostream& operator<<(std::ostream& os, Matrix2D m);
+std::ostream& operator<<(std::ostream& os, const Matrix2D& m);
+
+#ifdef MATH_HEADER_ONLY
+#include "Matrix2D.inl"
+#endif
@@ -0,0 +1,268 @@
+/*
+Title: Matrix Mathematics
+File Name: Matrix2D.inl
+Copyright  2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Definitions of the functions declared in Matrix2D.h (see MATH_HEADER_ONLY in helpers.h).
+#pragma once
+
+MATH_INLINE Matrix2D::Matrix2D() noexcept
+{
+	// The default constructor gives the identity matrix.
+	// 1s on the diagonal, 0s everywhere else.
+	columns[0] = Vector2D(1, 0);
+	columns[1] = Vector2D(0, 1);
+}
+
+MATH_INLINE Matrix2D::Matrix2D(float n00, float n01, float n10, float n11) noexcept
+{
+	// Remember, we store the elements internally in column-major,
+	// but still treat everything as if it were row-major.
+	// That's why column j holds the elements n0j and n1j
+	columns[0] = Vector2D(n00, n10);
+	columns[1] = Vector2D(n01, n11);
+}
+
+MATH_INLINE Matrix2D::Matrix2D(Vector2D a, Vector2D b) noexcept
+{
+	// This one needs no reordering at all: a and b already are the columns.
+	columns[0] = a;
+	columns[1] = b;
+}
+
+MATH_INLINE float& Matrix2D::operator()(int i, int j) noexcept
+{
+	// As a result of storing the matrix column-major, the (i, j) element of the matrix is component i of column j.
+	// This is why columns has the `private' access modifier and instead we have overloaded operator().
+	return columns[j].*VECTOR2D_COMPONENTS[i];
+}
+
+MATH_INLINE const float& Matrix2D::operator()(int i, int j) const noexcept
+{
+	return columns[j].*VECTOR2D_COMPONENTS[i];
+}
+
+MATH_INLINE Vector2D& Matrix2D::operator[](int j) noexcept
+{
+	// Operations like this are why we choose to store in column-major.
+	// When treating vectors as column vectors, as we often do in games,
+	//  it is useful to be able to access the columns of a matrix,
+	//  as you will see in operator*(Matrix, Vector)
+	return columns[j];
+}
+
+MATH_INLINE const Vector2D& Matrix2D::operator[](int j) const noexcept
+{
+	return columns[j];
+}
+
+MATH_INLINE Vector2D Matrix2D::row(int i) const noexcept
+{
+	// As stated in the header, the elements of the rows do not occupy continuous memory, so we must copy it to a new location.
+	return Vector2D((*this)(i, 0), (*this)(i, 1));
+}
+
+MATH_INLINE Vector2D& Matrix2D::col(int j) noexcept
+{
+	// Dereference this, then `call' the [] function.
+	return (*this)[j];
+}
+
+MATH_INLINE const Vector2D& Matrix2D::col(int j) const noexcept
+{
+	return (*this)[j];
+}
+
+MATH_INLINE Matrix2D operator-(const Matrix2D& m) noexcept
+{
+	// Here and for every operator defined on matrices, we can utilize the fact that
+	//  many of the operations we are defining are extremely similar to operations we have already defined.
+	// Where have we already defined them? For Vectors.
+	return Matrix2D(-m[0], -m[1]);
+}
+
+MATH_INLINE Matrix2D operator*(float s, const Matrix2D& m) noexcept
+{
+	return Matrix2D(s * m[0], s * m[1]);
+}
+
+MATH_INLINE Matrix2D operator*(const Matrix2D& m, float s) noexcept
+{
+	return s * m;
+}
+
+MATH_INLINE Matrix2D operator/(const Matrix2D& m, float s) noexcept
+{
+	return (1.0f / s)*m;
+}
+
+MATH_INLINE Matrix2D operator+(const Matrix2D& l, const Matrix2D& r) noexcept
+{
+	return Matrix2D(l[0] + r[0], l[1] + r[1]);
+}
+
+MATH_INLINE Matrix2D operator-(const Matrix2D& l, const Matrix2D& r) noexcept
+{
+	return l + (-r);
+}
+
+MATH_INLINE Matrix2D operator*(const Matrix2D& l, const Matrix2D& r) noexcept
+{
+	// Matrix multiplication can be computed as the dot product of rows into columns.
+	// In production code you would want to expand this, especially since this is just a 2D matrix,
+	//  but I have chosen mathematical meaning over speedy code.
+	return Matrix2D(Dot(l.row(0), r.col(0)), Dot(l.row(0), r.col(1)),
+		Dot(l.row(1), r.col(0)), Dot(l.row(1), r.col(1)));
+}
+
+MATH_INLINE Vector2D operator*(const Matrix2D& m, Vector2D v) noexcept
+{
+	// The product of a matrix with a column vector is a linear combination of the columns of the matrix.
+	return v.x * m[0] + v.y * m[1];
+}
+
+MATH_INLINE Vector2D operator*(Vector2D v, const Matrix2D& m) noexcept
+{
+	// The product of a row vector with a matrix is a linear combination of the rows of the matrix.
+	return v.x * m.row(0) + v.y * m.row(1);
+}
+
+MATH_INLINE bool operator==(const Matrix2D& l, const Matrix2D& r) noexcept
+{
+	return ((l[0] == r[0]) && (l[1] == r[1]));
+}
+
+MATH_INLINE bool operator!=(const Matrix2D& l, const Matrix2D& r) noexcept
+{
+	return !(l == r);
+}
+
+MATH_INLINE float Determinant(const Matrix2D& m) noexcept
+{
+	return m(0, 0) * m(1, 1) - m(0, 1) * m(1, 0);
+}
+
+MATH_INLINE Matrix2D Inverse(const Matrix2D& m) noexcept
+{
+	float invDet = 1.0f / Determinant(m);
+	return Matrix2D(m(1, 1) * invDet, -m(0, 1) * invDet, -m(1, 0) * invDet, m(0, 0) * invDet);
+}
+
+MATH_INLINE Matrix2D InverseAdj(const Matrix2D& m) noexcept
+{
+	return Adjugate(m) / Determinant(m);
+}
+
+MATH_INLINE float Minor(const Matrix2D& m, int i, int j) noexcept
+{
+	// We can use arithmetic mod 2 to just choose the other corner of the matrix than the one given by i and j.
+	return m((i + 1) % 2, (j + 1) % 2);
+}
+
+MATH_INLINE float Cofactor(const Matrix2D& m, int i, int j) noexcept
+{
+	return ((i + j) % 2 == 0 ? 1 : -1) * Minor(m, i, j);
+}
+
+MATH_INLINE Matrix2D CofactorMatrix(const Matrix2D& m) noexcept
+{
+	return Matrix2D(Cofactor(m, 0, 0), Cofactor(m, 0, 1),
+		Cofactor(m, 1, 0), Cofactor(m, 1, 1));
+}
+
+MATH_INLINE Matrix2D Adjugate(const Matrix2D& m) noexcept
+{
+	return Transpose(CofactorMatrix(m));
+}
+
+MATH_INLINE Matrix2D Transpose(const Matrix2D& m) noexcept
+{
+	// As with the row operation, Transpose must return a copy of the given matrix, instead of a reference to the original.
+	return Matrix2D(m.row(0), m.row(1));
+}
+
+MATH_INLINE Matrix2D Outer(Vector2D a, Vector2D b) noexcept
+{
+	return Matrix2D(a.x * b.x, a.x * b.y,
+		a.y * b.x, a.y * b.y);
+}
+
+MATH_INLINE Matrix2D MakeProjection(Vector2D b) noexcept
+{
+	// To prove this is correct, consider the Project(a, b) function, which projects a onto b.
+	// It returns (Dot(a, b) / Dot(b, b)) * b.
+	// Now that we have matrix multiplication, we can regard this more simply as
+	//  = 1/|b|^2 * Dot(b, a) * b, since the dot product is commutative
+	//  = 1/|b|^2 * b * Dot(b, a), since scalar multiplication is commutative
+	//  = 1/|b|^2 * b * (Transpose(b) * a), where a and b are considered as column vectors, so bT * a will return a "1x1 matrix", ie a scalar
+	//  = 1/|b|^2 * (b * Transpose(b)) * a, since matrix multiplication is associative
+	//  = (1/|b|^2 * Outer(b, b)) * a, by definition of the outer product
+	return (1 / MagSquared(b)) * Outer(b, b);
+}
+
+MATH_INLINE Matrix2D MakeRejection(Vector2D b) noexcept
+{
+	// Again, as proof of correctness,
+	// Reject(a, b) = a - Project(a, b)
+	//  = I*a - MakeProjection(b)*a, where I is the Identity matrix (1s along the diagonal and 0s everywhere else)
+	//  = (I - MakeProjection(b))*a
+	return Matrix2D() - MakeProjection(b);
+}
+
+MATH_INLINE Matrix2D MakeRotation(float theta) noexcept
+{
+	// To construct the matrix, we can consider the image of the standard basis unit vectors under the matrix.
+	// (We can do this since the result of a matrix-vector multiplication is a linear combination of the columns of the matrix.)
+	// Then, using the unit circle, we can determine that for a rotation by angle theta, M(theta),
+	//  we should have that M(theta)*(1, 0) = (cos(theta), sin(theta)), and
+	//  M(theta)*(0, 1) = (-sin(theta), cos(theta)).
+	// We simply then set the columns of the matrix equal to these vectors, and voila.
+	return Matrix2D(cosf(theta), -sinf(theta),
+		sinf(theta), cosf(theta));
+}
+
+MATH_INLINE Matrix2D ReflectMatrix(const Matrix2D& m, const Matrix2D& reflectionMatrix) noexcept
+{
+	// When we want to create a reflection image we multiply the vertex matrix of the our figure with what is called a relfection matrix.
+	// The most common reflection matrices are:
+
+	// For reflection on X-Axis:
+	// [1  0]
+	// [0 -1]
+
+	// For reflection on Y-Axis:
+	// [-1 0]
+	// [0  1]
+
+	// For reflection in the origin:
+	// [-1 0]
+	// [0 -1]
+
+	// For reflection in the line y = x:
+	// [0 1]
+	// [1 0]
+	return m * reflectionMatrix;
+}
+
+
+MATH_INLINE std::ostream& operator<<(std::ostream& os, const Matrix2D& m)
+{
+	os << "[ " << m(0, 0) << " " << m(0, 1) << " ]\n"
+		"[ " << m(1, 0) << " " << m(1, 1) << " ]\n";
+	return os;
+}
@@ -25,72 +25,310 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
 
+// The components of a Vector3D in order (see VECTOR2D_COMPONENTS).
+constexpr float Vector3D::* VECTOR3D_COMPONENTS[3] = { &Vector3D::x, &Vector3D::y, &Vector3D::z };
+
 // A 3 by 3 matrix of floats.
 struct Matrix3D
 {
 private:
-	float n[3][3];
+	// The columns, in the same column-major order as Matrix2D.
+	Vector3D columns[3];
 
 public:
-	Matrix3D();
+	constexpr Matrix3D() noexcept;
 
-	Matrix3D(float n00, float n01, float n02,
+	constexpr Matrix3D(float n00, float n01, float n02,
 		float n10, float n11, float n12,
-		float n20, float n21, float n22);
+		float n20, float n21, float n22) noexcept;
 
-	Matrix3D(Vector3D a, Vector3D b, Vector3D c);
+	constexpr Matrix3D(Vector3D a, Vector3D b, Vector3D c) noexcept;
 
-	float& operator()(int i, int j);
+	constexpr float& operator()(int i, int j) noexcept;
+	constexpr const float& operator()(int i, int j) const noexcept;
 
-	Vector3D& operator[](int j);
+	constexpr Vector3D& operator[](int j) noexcept;
+	constexpr const Vector3D& operator[](int j) const noexcept;
 
-	Vector3D row(int i);
-	Vector3D& col(int j);
+	constexpr Vector3D row(int i) const noexcept;
+	constexpr Vector3D& col(int j) noexcept;
+	constexpr const Vector3D& col(int j) const noexcept;
 };
 
-Matrix3D operator-(Matrix3D m);
-Matrix3D operator*(float s, Matrix3D m);
-Matrix3D operator*(Matrix3D m, float s);
-Matrix3D operator/(Matrix3D m, float s);
-Matrix3D operator+(Matrix3D l, Matrix3D r);
-Matrix3D operator-(Matrix3D l, Matrix3D r);
-Matrix3D operator*(Matrix3D l, Matrix3D r);
+constexpr Matrix3D operator-(const Matrix3D& m) noexcept;
+constexpr Matrix3D operator*(float s, const Matrix3D& m) noexcept;
+constexpr Matrix3D operator*(const Matrix3D& m, float s) noexcept;
+constexpr Matrix3D operator/(const Matrix3D& m, float s) noexcept;
+constexpr Matrix3D operator+(const Matrix3D& l, const Matrix3D& r) noexcept;
+constexpr Matrix3D operator-(const Matrix3D& l, const Matrix3D& r) noexcept;
+constexpr Matrix3D operator*(const Matrix3D& l, const Matrix3D& r) noexcept;
 
-Vector3D operator*(Matrix3D m, Vector3D v);
-Vector3D operator*(Vector3D v, Matrix3D m);
+constexpr Vector3D operator*(const Matrix3D& m, Vector3D v) noexcept;
+constexpr Vector3D operator*(Vector3D v, const Matrix3D& m) noexcept;
 
-bool operator==(Matrix3D l, Matrix3D r);
-bool operator!=(Matrix3D l, Matrix3D r);
+constexpr bool operator==(const Matrix3D& l, const Matrix3D& r) noexcept;
+constexpr bool operator!=(const Matrix3D& l, const Matrix3D& r) noexcept;
 
-float Determinant(Matrix3D m);
+constexpr float Determinant(const Matrix3D& m) noexcept;
 
-Matrix3D Inverse(Matrix3D m);
-Matrix3D InverseAdj(Matrix3D m);
-Matrix2D Minor(Matrix3D m, int i, int j);
-float Cofactor(Matrix3D m, int i, int j);
-Matrix3D CofactorMatrix(Matrix3D m);
-Matrix3D Adjugate(Matrix3D m);
+constexpr Matrix3D Inverse(const Matrix3D& m) noexcept;
+constexpr Matrix3D InverseAdj(const Matrix3D& m) noexcept;
+Matrix2D Minor(const Matrix3D& m, int i, int j) noexcept;
+float Cofactor(const Matrix3D& m, int i, int j) noexcept;
+// The cofactor matrix and adjugate are built from cross products of the columns, not from 9 separate minors.
+constexpr Matrix3D CofactorMatrix(const Matrix3D& m) noexcept;
+constexpr Matrix3D Adjugate(const Matrix3D& m) noexcept;
 
-Matrix3D Transpose(Matrix3D m);
+constexpr Matrix3D Transpose(const Matrix3D& m) noexcept;
 
-Matrix3D Outer(Vector3D a, Vector3D b);
-Matrix3D MakeProjection(Vector3D b);
-Matrix3D MakeRejection(Vector3D b);
+constexpr Matrix3D Outer(Vector3D a, Vector3D b) noexcept;
+constexpr Matrix3D MakeProjection(Vector3D b) noexcept;
+constexpr Matrix3D MakeRejection(Vector3D b) noexcept;
 
 // Returns a matrix representing a counter-clockwise rotation of theta radians about the x-axis.
-Matrix3D MakeRotationX(float theta);
+Matrix3D MakeRotationX(float theta) noexcept;
 
 // Returns a matrix representing a counter-clockwise rotation of theta radians about the y-axis.
-Matrix3D MakeRotationY(float theta);
+Matrix3D MakeRotationY(float theta) noexcept;
 
 // Returns a matrix representing a counter-clockwise rotation of theta radians about the z-axis.
-Matrix3D MakeRotationZ(float theta);
+Matrix3D MakeRotationZ(float theta) noexcept;
 
 // Returns a matrix representing a counter-clockwise rotation of theta radians about the vector v using Rodrigues' Formula.
-Matrix3D MakeRotation(float theta, Vector3D v);
+Matrix3D MakeRotation(float theta, Vector3D v) noexcept;
+
+// Same as MakeRotationX, MakeRotationY and MakeRotationZ, but can be evaluated at compile time.
+// At run time they are slower than the functions above, so only use them for constants.
+constexpr Matrix3D ConstexprRotationX(float theta) noexcept;
+constexpr Matrix3D ConstexprRotationY(float theta) noexcept;
+constexpr Matrix3D ConstexprRotationZ(float theta) noexcept;
 
 // Similar to MakeProjection and MakeRejection, CrossMat returns a matrix representing the "left cross product" by vector a.
 // That is, given two 3D vectors a and b, CrossMat(a) * b = Cross(a, b)
-Matrix3D CrossMat(Vector3D a);
+constexpr Matrix3D CrossMat(Vector3D a) noexcept;
+
+std::ostream& operator<<(std::ostream& os, const Matrix3D& m);
+
+// The constexpr functions are defined here so that they can be evaluated at compile time.
+
+constexpr Matrix3D::Matrix3D() noexcept
+	: columns{ Vector3D(1, 0, 0), Vector3D(0, 1, 0), Vector3D(0, 0, 1) }
+{
+}
+
+constexpr Matrix3D::Matrix3D(float n00, float n01, float n02, float n10, float n11, float n12, float n20, float n21, float n22) noexcept
+	: columns{ Vector3D(n00, n10, n20), Vector3D(n01, n11, n21), Vector3D(n02, n12, n22) }
+{
+}
+
+constexpr Matrix3D::Matrix3D(Vector3D a, Vector3D b, Vector3D c) noexcept
+	: columns{ a, b, c }
+{
+}
+
+constexpr float& Matrix3D::operator()(int i, int j) noexcept
+{
+	return columns[j].*VECTOR3D_COMPONENTS[i];
+}
+
+constexpr const float& Matrix3D::operator()(int i, int j) const noexcept
+{
+	return columns[j].*VECTOR3D_COMPONENTS[i];
+}
+
+constexpr Vector3D& Matrix3D::operator[](int j) noexcept
+{
+	return columns[j];
+}
+
+constexpr const Vector3D& Matrix3D::operator[](int j) const noexcept
+{
+	return columns[j];
+}
+
+constexpr Vector3D Matrix3D::row(int i) const noexcept
+{
+	return Vector3D((*this)(i, 0), (*this)(i, 1), (*this)(i, 2));
+}
+
+constexpr Vector3D& Matrix3D::col(int j) noexcept
+{
+	return columns[j];
+}
+
+constexpr const Vector3D& Matrix3D::col(int j) const noexcept
+{
+	return columns[j];
+}
+
+constexpr Matrix3D operator-(const Matrix3D& m) noexcept
+{
+	return -1.0f * m;
+}
+
+constexpr Matrix3D operator*(float s, const Matrix3D& m) noexcept
+{
+	return Matrix3D(s * m(0, 0), s * m(0, 1), s * m(0, 2),
+		s * m(1, 0), s * m(1, 1), s * m(1, 2),
+		s * m(2, 0), s * m(2, 1), s * m(2, 2));
+}
+
+constexpr Matrix3D operator*(const Matrix3D& m, float s) noexcept
+{
+	return s * m;
+}
+
+constexpr Matrix3D operator/(const Matrix3D& m, float s) noexcept
+{
+	return (1.0f / s)*m;
+}
+
+constexpr Matrix3D operator+(const Matrix3D& l, const Matrix3D& r) noexcept
+{
+	return Matrix3D(l(0, 0) + r(0, 0), l(0, 1) + r(0, 1), l(0, 2) + r(0, 2),
+		l(1, 0) + r(1, 0), l(1, 1) + r(1, 1), l(1, 2) + r(1, 2),
+		l(2, 0) + r(2, 0), l(2, 1) + r(2, 1), l(2, 2) + r(2, 2));
+}
+
+constexpr Matrix3D operator-(const Matrix3D& l, const Matrix3D& r) noexcept
+{
+	return l + (-r);
+}
+
+// The columns of r are the rows of its transpose
+constexpr Matrix3D operator*(const Matrix3D& l, const Matrix3D& r) noexcept
+{
+	Matrix3D t = Transpose(r);
+
+	return Matrix3D(Dot(l.row(0), t.row(0)), Dot(l.row(0), t.row(1)), Dot(l.row(0), t.row(2)),
+		Dot(l.row(1), t.row(0)), Dot(l.row(1), t.row(1)), Dot(l.row(1), t.row(2)),
+		Dot(l.row(2), t.row(0)), Dot(l.row(2), t.row(1)), Dot(l.row(2), t.row(2)));
+}
+
+constexpr Vector3D operator*(const Matrix3D& m, Vector3D v) noexcept
+{
+	return Vector3D(Dot(m.row(0), v), Dot(m.row(1), v), Dot(m.row(2), v));
+}
+
+constexpr Vector3D operator*(Vector3D v, const Matrix3D& m) noexcept
+{
+	return v.x * m.row(0) + v.y * m.row(1) + v.z * m.row(2);
+}
+
+constexpr bool operator==(const Matrix3D& l, const Matrix3D& r) noexcept
+{
+	return ((l.row(0) == r.row(0)) && (l.row(1) == r.row(1)) && (l.row(2) == r.row(2)));
+}
+
+constexpr bool operator!=(const Matrix3D& l, const Matrix3D& r) noexcept
+{
+	return !(l == r);
+}
+
+constexpr float Determinant(const Matrix3D& m) noexcept
+{
+	return m(0, 0) * m(1, 1) * m(2, 2) + m(0, 1) * m(1, 2) * m(2, 0) + m(0, 2) * m(1, 0) * m(2, 1)
+		- (m(0, 0) * m(1, 2) * m(2, 1) + m(0, 1) * m(1, 0) * m(2, 2) + m(0, 2) * m(1, 1) * m(2, 0));
+}
+
+constexpr Matrix3D Inverse(const Matrix3D& m) noexcept
+{
+	Vector3D a(m(0, 0), m(1, 0), m(2, 0));
+	Vector3D b(m(0, 1), m(1, 1), m(2, 1));
+	Vector3D c(m(0, 2), m(1, 2), m(2, 2));
+
+	Vector3D r0 = Cross(b, c);
+	Vector3D r1 = Cross(c, a);
+	Vector3D r2 = Cross(a, b);
+
+	float invDet = 1.0f / Dot(r2, c);
+
+	return Matrix3D(r0.x * invDet, r0.y * invDet, r0.z * invDet,
+		r1.x * invDet, r1.y * invDet, r1.z * invDet,
+		r2.x * invDet, r2.y * invDet, r2.z * invDet);
+}
+
+constexpr Matrix3D InverseAdj(const Matrix3D& m) noexcept
+{
+	return Adjugate(m) / Determinant(m);
+}
+
+// With columns a, b and c, the cofactors of the elements of column a are the components of b x c,
+//  and likewise c x a for column b and a x b for column c.
+// These are the same cross products that Inverse uses, before dividing by the determinant.
+constexpr Matrix3D CofactorMatrix(const Matrix3D& m) noexcept
+{
+	Vector3D a(m(0, 0), m(1, 0), m(2, 0));
+	Vector3D b(m(0, 1), m(1, 1), m(2, 1));
+	Vector3D c(m(0, 2), m(1, 2), m(2, 2));
+
+	return Matrix3D(Cross(b, c), Cross(c, a), Cross(a, b));
+}
+
+constexpr Matrix3D Adjugate(const Matrix3D& m) noexcept
+{
+	return Transpose(CofactorMatrix(m));
+}
+
+constexpr Matrix3D Transpose(const Matrix3D& m) noexcept
+{
+	return Matrix3D(m.row(0), m.row(1), m.row(2));
+}
+
+constexpr Matrix3D Outer(Vector3D a, Vector3D b) noexcept
+{
+	return Matrix3D(a.x * b.x, a.x * b.y, a.x * b.z,
+		a.y * b.x, a.y * b.y, a.y * b.z,
+		a.z * b.x, a.z * b.y, a.z * b.z);
+}
+
+constexpr Matrix3D MakeProjection(Vector3D b) noexcept
+{
+	return (1 / MagSquared(b)) * Outer(b, b);
+}
+
+constexpr Matrix3D MakeRejection(Vector3D b) noexcept
+{
+	return Matrix3D() - MakeProjection(b);
+}
+
+constexpr Matrix3D ConstexprRotationX(float theta) noexcept
+{
+	float c = (float)ConstexprCos(theta);
+	float s = (float)ConstexprSin(theta);
+
+	return Matrix3D(1, 0, 0,
+		0, c, -s,
+		0, s, c);
+}
+
+constexpr Matrix3D ConstexprRotationY(float theta) noexcept
+{
+	float c = (float)ConstexprCos(theta);
+	float s = (float)ConstexprSin(theta);
+
+	return Matrix3D(c, 0, s,
+		0, 1, 0,
+		-s, 0, c);
+}
+
+constexpr Matrix3D ConstexprRotationZ(float theta) noexcept
+{
+	float c = (float)ConstexprCos(theta);
+	float s = (float)ConstexprSin(theta);
+
+	return Matrix3D(c, -s, 0,
+		s, c, 0,
+		0, 0, 1);
+}
+
+constexpr Matrix3D CrossMat(Vector3D a) noexcept
+{
+	return Matrix3D(0, -a.z, a.y,
+		a.z, 0, -a.x,
+		-a.y, a.x, 0);
+}
 
-std::ostream& operator<<(std::ostream& os, Matrix3D m);
+#ifdef MATH_HEADER_ONLY
+#include "Matrix3D.inl"
+#endif
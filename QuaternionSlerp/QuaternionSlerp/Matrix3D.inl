@@ -0,0 +1,90 @@
+/*
+Title: Matrix Mathematics
+File Name: Matrix3D.inl
+Copyright  2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Definitions of the functions declared in Matrix3D.h (see MATH_HEADER_ONLY in helpers.h).
+#pragma once
+
+MATH_INLINE Matrix2D Minor(const Matrix3D& m, int i, int j) noexcept
+{
+	const int size = 2;
+	float n[size][size];
+	for (int k = 0, cRow = 0; k < size; k++, cRow++)
+	{
+		for (int l = 0, cCol = 0; l < size; l++, cCol++)
+		{
+			n[k][l] = m((cRow == i) ? ++cRow : cRow, (cCol == j) ? ++cCol : cCol);
+		}
+	}
+
+	return Matrix2D(n[0][0], n[0][1], n[1][0], n[1][1]);
+}
+
+MATH_INLINE float Cofactor(const Matrix3D& m, int i, int j) noexcept
+{
+	return ((i + j) % 2 == 0 ? 1 : -1) * Determinant(Minor(m, i, j));
+}
+
+MATH_INLINE Matrix3D MakeRotationX(float theta) noexcept
+{
+	float c = cosf(theta);
+	float s = sinf(theta);
+
+	return Matrix3D(1, 0, 0,
+		0, c, -s,
+		0, s, c);
+}
+
+MATH_INLINE Matrix3D MakeRotationY(float theta) noexcept
+{
+	float c = cosf(theta);
+	float s = sinf(theta);
+
+	return Matrix3D(c, 0, s,
+		0, 1, 0,
+		-s, 0, c);
+}
+
+MATH_INLINE Matrix3D MakeRotationZ(float theta) noexcept
+{
+	float c = cosf(theta);
+	float s = sinf(theta);
+
+	return Matrix3D(c, -s, 0,
+		s, c, 0,
+		0, 0, 1);
+}
+
+MATH_INLINE Matrix3D MakeRotation(float theta, Vector3D v) noexcept
+{
+	v = v * MagInverse(v);
+	float c = cosf(theta);
+	float s = sinf(theta);
+
+	// This is one possible statement of Rodrigues' Rotation formula
+	return c * Matrix3D() + (1 - c) * Outer(v, v) + s * CrossMat(v);
+}
+
+MATH_INLINE std::ostream& operator<<(std::ostream& os, const Matrix3D& m)
+{
+	os << "[ " << m(0, 0) << ", " << m(0, 1) << ", " << m(0, 2) << " ]\n"
+		"[ " << m(1, 0) << ", " << m(1, 1) << ", " << m(1, 2) << " ]\n"
+		"[ " << m(2, 0) << ", " << m(2, 1) << ", " << m(2, 2) << " ]\n";
+	return os;
+}
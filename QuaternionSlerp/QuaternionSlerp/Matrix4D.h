@@ -25,56 +25,81 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <iostream>
 
+// The components of a Vector4D in order (see VECTOR2D_COMPONENTS).
+constexpr float Vector4D::* VECTOR4D_COMPONENTS[4] = { &Vector4D::x, &Vector4D::y, &Vector4D::z, &Vector4D::w };
+
 struct Matrix4D
 {
 private:
-	float n[4][4];
+	// The columns, in the same column-major order as Matrix2D.
+	Vector4D columns[4];
 
 public:
-	Matrix4D();
+	Matrix4D() noexcept;
 
 	Matrix4D(float n00, float n01, float n02, float n03,
 		float n10, float n11, float n12, float n13,
 		float n20, float n21, float n22, float n23,
-		float n30, float n31, float n32, float n33);
+		float n30, float n31, float n32, float n33) noexcept;
 
-	Matrix4D(Vector4D a, Vector4D b, Vector4D c, Vector4D d);
+	Matrix4D(Vector4D a, Vector4D b, Vector4D c, Vector4D d) noexcept;
 
-	float& operator()(int i, int j);
+	float& operator()(int i, int j) noexcept;
+	const float& operator()(int i, int j) const noexcept;
 
-	Vector4D& operator[](int j);
+	Vector4D& operator[](int j) noexcept;
+	const Vector4D& operator[](int j) const noexcept;
 
-	Vector4D row(int i);
-	Vector4D& col(int j);
+	Vector4D row(int i) const noexcept;
+	Vector4D& col(int j) noexcept;
+	const Vector4D& col(int j) const noexcept;
 };
 
-Matrix4D operator-(Matrix4D m);
-Matrix4D operator*(float s, Matrix4D m);
-Matrix4D operator*(Matrix4D m, float s);
-Matrix4D operator/(Matrix4D m, float s);
-Matrix4D operator+(Matrix4D l, Matrix4D r);
-Matrix4D operator-(Matrix4D l, Matrix4D r);
-Matrix4D operator*(Matrix4D l, Matrix4D r);
-
-Vector4D operator*(Matrix4D m, Vector4D v);
-Vector4D operator*(Vector4D v, Matrix4D m);
-
-bool operator==(Matrix4D l, Matrix4D r);
-bool operator!=(Matrix4D l, Matrix4D r);
-
-float Determinant(Matrix4D m);
-
-Matrix4D Inverse(Matrix4D m);
-Matrix4D InverseAdj(Matrix4D m);
-Matrix3D Minor(Matrix4D m, int i, int j);
-float Cofactor(Matrix4D m, int i, int j);
-Matrix4D CofactorMatrix(Matrix4D m);
-Matrix4D Adjugate(Matrix4D m);
-
-Matrix4D Transpose(Matrix4D m);
-
-Matrix4D Outer(Vector4D a, Vector4D b);
-Matrix4D MakeProjection(Vector4D b);
-Matrix4D MakeRejection(Vector4D b);
-
-std::ostream& operator<<(std::ostream& os, Matrix4D m);
+Matrix4D operator-(const Matrix4D& m) noexcept;
+Matrix4D operator*(float s, const Matrix4D& m) noexcept;
+Matrix4D operator*(const Matrix4D& m, float s) noexcept;
+Matrix4D operator/(const Matrix4D& m, float s) noexcept;
+Matrix4D operator+(const Matrix4D& l, const Matrix4D& r) noexcept;
+Matrix4D operator-(const Matrix4D& l, const Matrix4D& r) noexcept;
+Matrix4D operator*(const Matrix4D& l, const Matrix4D& r) noexcept;
+
+Vector4D operator*(const Matrix4D& m, Vector4D v) noexcept;
+Vector4D operator*(Vector4D v, const Matrix4D& m) noexcept;
+
+bool operator==(const Matrix4D& l, const Matrix4D& r) noexcept;
+bool operator!=(const Matrix4D& l, const Matrix4D& r) noexcept;
+
+float Determinant(const Matrix4D& m) noexcept;
+
+Matrix4D Inverse(const Matrix4D& m) noexcept;
+Matrix4D InverseAdj(const Matrix4D& m) noexcept;
+
+// Most transforms are one of two special classes of matrix, whose inverses take much less work than the general one.
+// Affine matrices have a bottom row of (0, 0, 0, 1): x' = A x + t, so x = A^-1 x' - A^-1 t,
+//  and only the 3x3 part A needs inverting.
+// Rigid matrices are affine with a rotation for A (no scaling or shearing), and the inverse of a rotation is its transpose.
+// Classify finds the class of a matrix, treating the upper 3x3 as a rotation if each element of A^T A is within
+//  tolerance of the identity. The inverses assume the matrix is of their class without checking.
+enum class MatrixClass { General, Affine, Rigid };
+MatrixClass Classify(const Matrix4D& m, float tolerance = 1e-5f) noexcept;
+Matrix4D InverseAffine(const Matrix4D& m) noexcept;
+Matrix4D InverseRigid(const Matrix4D& m) noexcept;
+Matrix4D Inverse(const Matrix4D& m, MatrixClass c) noexcept;
+Matrix3D Minor(const Matrix4D& m, int i, int j) noexcept;
+float Cofactor(const Matrix4D& m, int i, int j) noexcept;
+// The cofactor matrix and adjugate are worked out in closed form, with the same cross products as Inverse,
+//  instead of from 16 separate 3x3 minors.
+Matrix4D CofactorMatrix(const Matrix4D& m) noexcept;
+Matrix4D Adjugate(const Matrix4D& m) noexcept;
+
+Matrix4D Transpose(const Matrix4D& m) noexcept;
+
+Matrix4D Outer(Vector4D a, Vector4D b) noexcept;
+Matrix4D MakeProjection(Vector4D b) noexcept;
+Matrix4D MakeRejection(Vector4D b) noexcept;
+
+std::ostream& operator<<(std::ostream& os, const Matrix4D& m);
+
+#ifdef MATH_HEADER_ONLY
+#include "Matrix4D.inl"
+#endif
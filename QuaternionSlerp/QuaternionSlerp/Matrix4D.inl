@@ -0,0 +1,362 @@
+/*
+Title: Matrix Mathematics
+File Name: Matrix4D.inl
+Copyright  2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Definitions of the functions declared in Matrix4D.h (see MATH_HEADER_ONLY in helpers.h).
+#pragma once
+
+MATH_INLINE Matrix4D::Matrix4D() noexcept
+{
+	columns[0] = Vector4D(1, 0, 0, 0);
+	columns[1] = Vector4D(0, 1, 0, 0);
+	columns[2] = Vector4D(0, 0, 1, 0);
+	columns[3] = Vector4D(0, 0, 0, 1);
+}
+
+MATH_INLINE Matrix4D::Matrix4D(float n00, float n01, float n02, float n03,
+	float n10, float n11, float n12, float n13,
+	float n20, float n21, float n22, float n23,
+	float n30, float n31, float n32, float n33) noexcept
+{
+	columns[0] = Vector4D(n00, n10, n20, n30);
+	columns[1] = Vector4D(n01, n11, n21, n31);
+	columns[2] = Vector4D(n02, n12, n22, n32);
+	columns[3] = Vector4D(n03, n13, n23, n33);
+}
+
+MATH_INLINE Matrix4D::Matrix4D(Vector4D a, Vector4D b, Vector4D c, Vector4D d) noexcept
+{
+	columns[0] = a;
+	columns[1] = b;
+	columns[2] = c;
+	columns[3] = d;
+}
+
+MATH_INLINE float& Matrix4D::operator()(int i, int j) noexcept
+{
+	return columns[j].*VECTOR4D_COMPONENTS[i];
+}
+
+MATH_INLINE const float& Matrix4D::operator()(int i, int j) const noexcept
+{
+	return columns[j].*VECTOR4D_COMPONENTS[i];
+}
+
+MATH_INLINE Vector4D& Matrix4D::operator[](int j) noexcept
+{
+	return columns[j];
+}
+
+MATH_INLINE const Vector4D& Matrix4D::operator[](int j) const noexcept
+{
+	return columns[j];
+}
+
+MATH_INLINE Vector4D Matrix4D::row(int i) const noexcept
+{
+	return Vector4D((*this)(i, 0), (*this)(i, 1), (*this)(i, 2), (*this)(i, 3));
+}
+
+MATH_INLINE Vector4D& Matrix4D::col(int j) noexcept
+{
+	return (*this)[j];
+}
+
+MATH_INLINE const Vector4D& Matrix4D::col(int j) const noexcept
+{
+	return (*this)[j];
+}
+
+MATH_INLINE Matrix4D operator-(const Matrix4D& m) noexcept
+{
+	return Matrix4D(-m[0], -m[1], -m[2], -m[3]);
+}
+
+MATH_INLINE Matrix4D operator*(float s, const Matrix4D& m) noexcept
+{
+	return Matrix4D(s*m[0], s*m[1], s*m[2], s*m[3]);
+}
+
+MATH_INLINE Matrix4D operator*(const Matrix4D& m, float s) noexcept
+{
+	return s * m;
+}
+
+MATH_INLINE Matrix4D operator/(const Matrix4D& m, float s) noexcept
+{
+	return (1.0f / s)*m;
+}
+
+MATH_INLINE Matrix4D operator+(const Matrix4D& l, const Matrix4D& r) noexcept
+{
+	return Matrix4D(l[0] + r[0], l[1] + r[1], l[2] + r[2], l[3] + r[3]);
+}
+
+MATH_INLINE Matrix4D operator-(const Matrix4D& l, const Matrix4D& r) noexcept
+{
+	return l + (-r);
+}
+
+// Column j of l * r is l times column j of r, that is the columns of l weighted by the elements of that column:
+//  (l * r)[j] = l[0] * r(0, j) + l[1] * r(1, j) + l[2] * r(2, j) + l[3] * r(3, j)
+// Each column of l is a whole SSE register and each r(k, j) is broadcast across one,
+//  so this compiles to 16 vector multiplies and 12 adds with no shuffling of rows.
+MATH_INLINE Matrix4D operator*(const Matrix4D& l, const Matrix4D& r) noexcept
+{
+	const Vector4D& a = l[0];
+	const Vector4D& b = l[1];
+	const Vector4D& c = l[2];
+	const Vector4D& d = l[3];
+
+	return Matrix4D(a * r(0, 0) + b * r(1, 0) + c * r(2, 0) + d * r(3, 0),
+		a * r(0, 1) + b * r(1, 1) + c * r(2, 1) + d * r(3, 1),
+		a * r(0, 2) + b * r(1, 2) + c * r(2, 2) + d * r(3, 2),
+		a * r(0, 3) + b * r(1, 3) + c * r(2, 3) + d * r(3, 3));
+}
+
+MATH_INLINE Vector4D operator*(const Matrix4D& m, Vector4D v) noexcept
+{
+	return v.x * m[0] + v.y * m[1] + v.z * m[2] + v.w * m[3];
+}
+
+MATH_INLINE Vector4D operator*(Vector4D v, const Matrix4D& m) noexcept
+{
+	return v.x * m.row(0) + v.y * m.row(1) + v.z * m.row(2) + v.w * m.row(3);
+}
+
+MATH_INLINE bool operator==(const Matrix4D& l, const Matrix4D& r) noexcept
+{
+	return ((l[0] == r[0]) && (l[1] == r[1]) && (l[2] == r[2]) && (l[3] == r[3]));
+}
+
+MATH_INLINE bool operator!=(const Matrix4D& l, const Matrix4D& r) noexcept
+{
+	return !(l == r);
+}
+
+MATH_INLINE float Determinant(const Matrix4D& m) noexcept
+{
+	Vector3D a(m(0, 0), m(1, 0), m(2, 0));
+	Vector3D b(m(0, 1), m(1, 1), m(2, 1));
+	Vector3D c(m(0, 2), m(1, 2), m(2, 2));
+	Vector3D d(m(0, 3), m(1, 3), m(2, 3));
+
+	const float& x = m(3, 0);
+	const float& y = m(3, 1);
+	const float& z = m(3, 2);
+	const float& w = m(3, 3);
+
+	Vector3D s = Cross(a, b);
+	Vector3D t = Cross(c, d);
+	Vector3D u = a * y - b * x;
+	Vector3D v = c * w - d * z;
+
+	return Dot(s, v) + Dot(t, u);
+}
+
+MATH_INLINE Matrix4D Inverse(const Matrix4D& m) noexcept
+{
+	Vector3D a(m(0, 0), m(1, 0), m(2, 0));
+	Vector3D b(m(0, 1), m(1, 1), m(2, 1));
+	Vector3D c(m(0, 2), m(1, 2), m(2, 2));
+	Vector3D d(m(0, 3), m(1, 3), m(2, 3));
+
+	const float& x = m(3, 0);
+	const float& y = m(3, 1);
+	const float& z = m(3, 2);
+	const float& w = m(3, 3);
+
+	Vector3D s = Cross(a, b);
+	Vector3D t = Cross(c, d);
+	Vector3D u = a * y - b * x;
+	Vector3D v = c * w - d * z;
+
+	float invDet = 1.0f / (Dot(s, v) + Dot(t, u));
+	s = s * invDet;
+	t = t * invDet;
+	u = u * invDet;
+	v = v * invDet;
+
+	Vector3D r0 = Cross(b, v) + t * y;
+	Vector3D r1 = Cross(v, a) - t * x;
+	Vector3D r2 = Cross(d, u) + s * w;
+	Vector3D r3 = Cross(u, c) - s * z;
+
+	return Matrix4D(r0.x, r0.y, r0.z, -Dot(b, t),
+		r1.x, r1.y, r1.z, Dot(a, t),
+		r2.x, r2.y, r2.z, -Dot(d, s),
+		r3.x, r3.y, r3.z, Dot(c, s));
+}
+
+MATH_INLINE Matrix4D InverseAdj(const Matrix4D& m) noexcept
+{
+	return Adjugate(m) / Determinant(m);
+}
+
+MATH_INLINE MatrixClass Classify(const Matrix4D& m, float tolerance) noexcept
+{
+	if (m(3, 0) != 0 || m(3, 1) != 0 || m(3, 2) != 0 || m(3, 3) != 1)
+	{
+		return MatrixClass::General;
+	}
+
+	Vector3D a(m(0, 0), m(1, 0), m(2, 0));
+	Vector3D b(m(0, 1), m(1, 1), m(2, 1));
+	Vector3D c(m(0, 2), m(1, 2), m(2, 2));
+
+	// The elements of A^T A are the dot products of the columns.
+	bool orthonormal = fabsf(Dot(a, a) - 1) <= tolerance
+		&& fabsf(Dot(b, b) - 1) <= tolerance
+		&& fabsf(Dot(c, c) - 1) <= tolerance
+		&& fabsf(Dot(a, b)) <= tolerance
+		&& fabsf(Dot(b, c)) <= tolerance
+		&& fabsf(Dot(c, a)) <= tolerance;
+
+	return orthonormal ? MatrixClass::Rigid : MatrixClass::Affine;
+}
+
+MATH_INLINE Matrix4D InverseAffine(const Matrix4D& m) noexcept
+{
+	Matrix3D a = Inverse(Matrix3D(m(0, 0), m(0, 1), m(0, 2),
+		m(1, 0), m(1, 1), m(1, 2),
+		m(2, 0), m(2, 1), m(2, 2)));
+	Vector3D t = -(a * Vector3D(m(0, 3), m(1, 3), m(2, 3)));
+
+	return Matrix4D(a(0, 0), a(0, 1), a(0, 2), t.x,
+		a(1, 0), a(1, 1), a(1, 2), t.y,
+		a(2, 0), a(2, 1), a(2, 2), t.z,
+		0, 0, 0, 1);
+}
+
+// The rows of the inverse rotation are the columns of the rotation, so the new translation is
+//  -R^T t, the dot products of each column with t.
+MATH_INLINE Matrix4D InverseRigid(const Matrix4D& m) noexcept
+{
+	Vector3D a(m(0, 0), m(1, 0), m(2, 0));
+	Vector3D b(m(0, 1), m(1, 1), m(2, 1));
+	Vector3D c(m(0, 2), m(1, 2), m(2, 2));
+	Vector3D t(m(0, 3), m(1, 3), m(2, 3));
+
+	return Matrix4D(a.x, a.y, a.z, -Dot(a, t),
+		b.x, b.y, b.z, -Dot(b, t),
+		c.x, c.y, c.z, -Dot(c, t),
+		0, 0, 0, 1);
+}
+
+MATH_INLINE Matrix4D Inverse(const Matrix4D& m, MatrixClass c) noexcept
+{
+	switch (c)
+	{
+	case MatrixClass::Rigid:
+		return InverseRigid(m);
+	case MatrixClass::Affine:
+		return InverseAffine(m);
+	default:
+		return Inverse(m);
+	}
+}
+
+MATH_INLINE Matrix3D Minor(const Matrix4D& m, int i, int j) noexcept
+{
+	const int size = 3;
+	float n[size][size];
+	for (int k = 0, cRow = 0; k < size; k++, cRow++)
+	{
+		for (int l = 0, cCol = 0; l < size; l++, cCol++)
+		{
+			n[k][l] = m((cRow == i) ? ++cRow : cRow, (cCol == j) ? ++cCol : cCol);
+		}
+	}
+
+	return Matrix3D(n[0][0], n[0][1], n[0][2],
+		n[1][0], n[1][1], n[1][2],
+		n[2][0], n[2][1], n[2][2]);
+}
+
+MATH_INLINE float Cofactor(const Matrix4D& m, int i, int j) noexcept
+{
+	return ((i + j) % 2 == 0 ? 1 : -1) * Determinant(Minor(m, i, j));
+}
+
+MATH_INLINE Matrix4D CofactorMatrix(const Matrix4D& m) noexcept
+{
+	return Transpose(Adjugate(m));
+}
+
+// Inverse(m) is Adjugate(m) / Determinant(m), so the adjugate is the same calculation as Inverse
+//  without dividing s, t, u and v by the determinant.
+MATH_INLINE Matrix4D Adjugate(const Matrix4D& m) noexcept
+{
+	Vector3D a(m(0, 0), m(1, 0), m(2, 0));
+	Vector3D b(m(0, 1), m(1, 1), m(2, 1));
+	Vector3D c(m(0, 2), m(1, 2), m(2, 2));
+	Vector3D d(m(0, 3), m(1, 3), m(2, 3));
+
+	float x = m(3, 0);
+	float y = m(3, 1);
+	float z = m(3, 2);
+	float w = m(3, 3);
+
+	Vector3D s = Cross(a, b);
+	Vector3D t = Cross(c, d);
+	Vector3D u = a * y - b * x;
+	Vector3D v = c * w - d * z;
+
+	Vector3D r0 = Cross(b, v) + t * y;
+	Vector3D r1 = Cross(v, a) - t * x;
+	Vector3D r2 = Cross(d, u) + s * w;
+	Vector3D r3 = Cross(u, c) - s * z;
+
+	return Matrix4D(r0.x, r0.y, r0.z, -Dot(b, t),
+		r1.x, r1.y, r1.z, Dot(a, t),
+		r2.x, r2.y, r2.z, -Dot(d, s),
+		r3.x, r3.y, r3.z, Dot(c, s));
+}
+
+MATH_INLINE Matrix4D Transpose(const Matrix4D& m) noexcept
+{
+	return Matrix4D(m.row(0), m.row(1), m.row(2), m.row(3));
+}
+
+MATH_INLINE Matrix4D Outer(Vector4D a, Vector4D b) noexcept
+{
+	return Matrix4D(a.x * b.x, a.x * b.y, a.x * b.z, a.x * b.w,
+		a.y * b.x, a.y * b.y, a.y * b.z, a.y * b.w,
+		a.z * b.x, a.z * b.y, a.z * b.z, a.z * b.w,
+		a.w * b.x, a.w * b.y, a.w * b.z, a.w * b.w);
+}
+
+MATH_INLINE Matrix4D MakeProjection(Vector4D b) noexcept
+{
+	return (1 / MagSquared(b)) * Outer(b, b);
+}
+
+MATH_INLINE Matrix4D MakeRejection(Vector4D b) noexcept
+{
+	return Matrix4D() - MakeProjection(b);
+}
+
+MATH_INLINE std::ostream& operator<<(std::ostream& os, const Matrix4D& m)
+{
+	os << "[ " << m(0, 0) << ", " << m(0, 1) << ", " << m(0, 2) << ", " << m(0, 3) << " ]\n"
+		"[ " << m(1, 0) << ", " << m(1, 1) << ", " << m(1, 2) << ", " << m(1, 3) << " ]\n"
+		"[ " << m(2, 0) << ", " << m(2, 1) << ", " << m(2, 2) << ", " << m(2, 3) << " ]\n"
+		"[ " << m(3, 0) << ", " << m(3, 1) << ", " << m(3, 2) << ", " << m(3, 3) << " ]\n";
+	return os;
+}
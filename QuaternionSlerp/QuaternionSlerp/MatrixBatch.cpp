@@ -0,0 +1,388 @@
+/*
+Title: Matrix Mathematics
+File Name: MatrixBatch.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "MatrixBatch.h"
+#include "Parallel.h"
+
+#include <algorithm>
+#include <atomic>
+
+// The products below all go through Matrix4D's operator*, which works on whole columns,
+//  so each one is 16 vector multiplies and 12 vector adds.
+
+void MultiplyMatrices(const Matrix4D* l, const Matrix4D* r, Matrix4D* out, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		out[i] = l[i] * r[i];
+	}
+}
+
+void ComposeChain(Matrix4D* m, int count)
+{
+	for (int i = 1; i < count; i++)
+	{
+		m[i] = m[i - 1] * m[i];
+	}
+}
+
+// Two running products, over the first and second half of the chain, are independent of each other,
+//  so the processor can work on both at once instead of waiting for each product to finish before the next.
+Matrix4D MultiplyChain(const Matrix4D* m, int count)
+{
+	int half = count / 2;
+	Matrix4D first, second;
+
+	for (int i = 0; i < half; i++)
+	{
+		first = first * m[i];
+		second = second * m[half + i];
+	}
+
+	if (count % 2 != 0)
+	{
+		second = second * m[count - 1];
+	}
+
+	return first * second;
+}
+
+void Inverses(const Matrix4D* m, const MatrixClass* c, Matrix4D* out, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		out[i] = Inverse(m[i], c[i]);
+	}
+}
+
+// The batch kernels below work on blocks of BLOCK matrices.
+// Each block is copied into local arrays with one array per element, r[k][i] holding element k of matrix i
+//  in column-major order, the kernel works on those, and then the results are copied out.
+// That way the kernels are loops over separate arrays, which the compiler vectorizes across matrices,
+//  and the output may overwrite the input.
+// Matrix3D and Matrix4D hold nothing but their column-major elements, so the copies read and write them as floats.
+static const int BLOCK = 64;
+
+template <int N>
+static void Load(const float* m, int n, float r[N][BLOCK])
+{
+	for (int i = 0; i < n; i++)
+	{
+		for (int k = 0; k < N; k++)
+		{
+			r[k][i] = m[N * i + k];
+		}
+	}
+}
+
+template <int N>
+static void Store(float r[N][BLOCK], int n, float* m)
+{
+	for (int i = 0; i < n; i++)
+	{
+		for (int k = 0; k < N; k++)
+		{
+			m[N * i + k] = r[k][i];
+		}
+	}
+}
+
+// The cofactor matrix of the 3x3 matrices in r, written to o (see CofactorMatrix in Matrix3D.h).
+// With TRANSPOSE the adjugate is written instead.
+// The stride is the number of elements in a column of r, so the upper left 3x3 of 4x4 matrices can be read too.
+template <bool TRANSPOSE>
+static void CofactorBlock3(const float (*r)[BLOCK], int stride, int n, float o[9][BLOCK])
+{
+	for (int i = 0; i < n; i++)
+	{
+		float ax = r[0][i], ay = r[1][i], az = r[2][i];
+		float bx = r[stride][i], by = r[stride + 1][i], bz = r[stride + 2][i];
+		float cx = r[2 * stride][i], cy = r[2 * stride + 1][i], cz = r[2 * stride + 2][i];
+
+		// Column j of the cofactor matrix, which is row j of the adjugate, is o[3 * j] to o[3 * j + 2]
+		//  or o[j], o[3 + j], o[6 + j]
+		const int s = TRANSPOSE ? 1 : 3;
+		const int e = TRANSPOSE ? 3 : 1;
+
+		// b x c
+		o[0 * s + 0 * e][i] = by * cz - bz * cy;
+		o[0 * s + 1 * e][i] = bz * cx - bx * cz;
+		o[0 * s + 2 * e][i] = bx * cy - by * cx;
+
+		// c x a
+		o[1 * s + 0 * e][i] = cy * az - cz * ay;
+		o[1 * s + 1 * e][i] = cz * ax - cx * az;
+		o[1 * s + 2 * e][i] = cx * ay - cy * ax;
+
+		// a x b
+		o[2 * s + 0 * e][i] = ay * bz - az * by;
+		o[2 * s + 1 * e][i] = az * bx - ax * bz;
+		o[2 * s + 2 * e][i] = ax * by - ay * bx;
+	}
+}
+
+// The adjugate of the 4x4 matrices in r, written to o, with the same formulas as Adjugate in Matrix4D.inl.
+// With TRANSPOSE the cofactor matrix is written instead.
+template <bool TRANSPOSE>
+static void AdjugateBlock4(float r[16][BLOCK], int n, float o[16][BLOCK])
+{
+	for (int i = 0; i < n; i++)
+	{
+		Vector3D a(r[0][i], r[1][i], r[2][i]);
+		Vector3D b(r[4][i], r[5][i], r[6][i]);
+		Vector3D c(r[8][i], r[9][i], r[10][i]);
+		Vector3D d(r[12][i], r[13][i], r[14][i]);
+		float x = r[3][i], y = r[7][i], z = r[11][i], w = r[15][i];
+
+		Vector3D s = Cross(a, b);
+		Vector3D t = Cross(c, d);
+		Vector3D u = a * y - b * x;
+		Vector3D v = c * w - d * z;
+
+		// Rows of the adjugate
+		Vector3D r0 = Cross(b, v) + t * y;
+		Vector3D r1 = Cross(v, a) - t * x;
+		Vector3D r2 = Cross(d, u) + s * w;
+		Vector3D r3 = Cross(u, c) - s * z;
+		float row[4][4] = {
+			{ r0.x, r0.y, r0.z, -Dot(b, t) },
+			{ r1.x, r1.y, r1.z, Dot(a, t) },
+			{ r2.x, r2.y, r2.z, -Dot(d, s) },
+			{ r3.x, r3.y, r3.z, Dot(c, s) } };
+
+		for (int j = 0; j < 4; j++)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				o[TRANSPOSE ? 4 * j + k : 4 * k + j][i] = row[j][k];
+			}
+		}
+	}
+}
+
+void Adjugates(const Matrix3D* m, Matrix3D* out, int count)
+{
+	float r[9][BLOCK], o[9][BLOCK];
+
+	for (int start = 0; start < count; start += BLOCK)
+	{
+		int n = (count - start < BLOCK) ? count - start : BLOCK;
+		Load<9>((const float*)(m + start), n, r);
+		CofactorBlock3<true>(r, 3, n, o);
+		Store<9>(o, n, (float*)(out + start));
+	}
+}
+
+void Adjugates(const Matrix4D* m, Matrix4D* out, int count)
+{
+	float r[16][BLOCK], o[16][BLOCK];
+
+	for (int start = 0; start < count; start += BLOCK)
+	{
+		int n = (count - start < BLOCK) ? count - start : BLOCK;
+		Load<16>((const float*)(m + start), n, r);
+		AdjugateBlock4<false>(r, n, o);
+		Store<16>(o, n, (float*)(out + start));
+	}
+}
+
+void CofactorMatrices(const Matrix3D* m, Matrix3D* out, int count)
+{
+	float r[9][BLOCK], o[9][BLOCK];
+
+	for (int start = 0; start < count; start += BLOCK)
+	{
+		int n = (count - start < BLOCK) ? count - start : BLOCK;
+		Load<9>((const float*)(m + start), n, r);
+		CofactorBlock3<false>(r, 3, n, o);
+		Store<9>(o, n, (float*)(out + start));
+	}
+}
+
+void CofactorMatrices(const Matrix4D* m, Matrix4D* out, int count)
+{
+	float r[16][BLOCK], o[16][BLOCK];
+
+	for (int start = 0; start < count; start += BLOCK)
+	{
+		int n = (count - start < BLOCK) ? count - start : BLOCK;
+		Load<16>((const float*)(m + start), n, r);
+		AdjugateBlock4<true>(r, n, o);
+		Store<16>(o, n, (float*)(out + start));
+	}
+}
+
+void NormalMatrices(const Matrix4D* m, Matrix3D* out, int count)
+{
+	float r[16][BLOCK], o[9][BLOCK];
+
+	for (int start = 0; start < count; start += BLOCK)
+	{
+		int n = (count - start < BLOCK) ? count - start : BLOCK;
+		Load<16>((const float*)(m + start), n, r);
+		CofactorBlock3<false>(r, 4, n, o);
+		Store<9>(o, n, (float*)(out + start));
+	}
+}
+
+// Below this many matrices per thread, starting the threads costs more than it saves
+static const int INVERSE_CHUNK = 16384;
+
+// A matrix is treated as singular when its determinant is at most this fraction of the product of
+//  its column lengths, which is the largest the determinant could be for those columns.
+// Comparing the squares needs no square roots, and being relative makes the test independent of scale.
+static const float SINGULAR_TOLERANCE = 1e-6f;
+
+// Determinants of the matrices in r, using the columns' cross product as in Inverse.
+static void DeterminantBlock(float (* __restrict r)[BLOCK], int n, float* __restrict out)
+{
+	for (int i = 0; i < n; i++)
+	{
+		Vector3D a(r[0][i], r[1][i], r[2][i]);
+		Vector3D b(r[3][i], r[4][i], r[5][i]);
+		Vector3D c(r[6][i], r[7][i], r[8][i]);
+		out[i] = Dot(Cross(a, b), c);
+	}
+}
+
+// Inverses of the matrices in r, written to o, with the same cross products as Inverse in Matrix3D.h.
+// Singular lanes divide by 1 instead of the determinant and are then multiplied by 0,
+//  so that no infinities or NaNs are produced and the loop has no branches.
+// Returns the number of singular lanes, and marks them in singular.
+// r, o and singular are separate blocks, and __restrict says so, as in SlerpKernel. Once this is inlined the compiler
+//  can see that for itself, but without it a call that isn't inlined would have to check at run time that none
+//  of the 19 rows overlap before taking the vectorized loop.
+static int InverseBlock(float (* __restrict r)[BLOCK], int n, float (* __restrict o)[BLOCK], int* __restrict singular)
+{
+	int singularCount = 0;
+
+	for (int i = 0; i < n; i++)
+	{
+		Vector3D a(r[0][i], r[1][i], r[2][i]);
+		Vector3D b(r[3][i], r[4][i], r[5][i]);
+		Vector3D c(r[6][i], r[7][i], r[8][i]);
+
+		Vector3D r0 = Cross(b, c);
+		Vector3D r1 = Cross(c, a);
+		Vector3D r2 = Cross(a, b);
+		float det = Dot(r2, c);
+
+		bool isSingular = det * det <= SINGULAR_TOLERANCE * SINGULAR_TOLERANCE * Dot(a, a) * Dot(b, b) * Dot(c, c);
+		float invDet = (isSingular ? 0.0f : 1.0f) / (isSingular ? 1.0f : det);
+
+		// Row j of the inverse is element j of each of r0, r1 and r2
+		o[0][i] = r0.x * invDet; o[3][i] = r0.y * invDet; o[6][i] = r0.z * invDet;
+		o[1][i] = r1.x * invDet; o[4][i] = r1.y * invDet; o[7][i] = r1.z * invDet;
+		o[2][i] = r2.x * invDet; o[5][i] = r2.y * invDet; o[8][i] = r2.z * invDet;
+		singular[i] = isSingular;
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		singularCount += singular[i];
+	}
+
+	return singularCount;
+}
+
+// Copies n matrices between SoA arrays and the local arrays of a block. Each element is a contiguous copy.
+static void LoadSoA(Matrix3DSoA m, int start, int n, float r[9][BLOCK])
+{
+	for (int k = 0; k < 9; k++)
+	{
+		std::copy(m.n[k] + start, m.n[k] + start + n, r[k]);
+	}
+}
+
+static void StoreSoA(float r[9][BLOCK], int start, int n, Matrix3DSoA m)
+{
+	for (int k = 0; k < 9; k++)
+	{
+		std::copy(r[k], r[k] + n, m.n[k] + start);
+	}
+}
+
+static void CopySingular(const int flags[BLOCK], int n, bool* singular)
+{
+	if (singular != nullptr)
+	{
+		std::copy(flags, flags + n, singular);
+	}
+}
+
+void ToSoA(const Matrix3D* m, Matrix3DSoA out, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		for (int k = 0; k < 9; k++)
+		{
+			out.n[k][i] = m[i](k % 3, k / 3);
+		}
+	}
+}
+
+void FromSoA(Matrix3DSoA m, Matrix3D* out, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		for (int k = 0; k < 9; k++)
+		{
+			out[i](k % 3, k / 3) = m.n[k][i];
+		}
+	}
+}
+
+void Determinants(Matrix3DSoA m, float* out, int count, int threads)
+{
+	ParallelFor(count, threads, INVERSE_CHUNK, [=](int begin, int end)
+	{
+		float r[9][BLOCK];
+
+		for (int start = begin; start < end; start += BLOCK)
+		{
+			int n = (end - start < BLOCK) ? end - start : BLOCK;
+			LoadSoA(m, start, n, r);
+			DeterminantBlock(r, n, out + start);
+		}
+	});
+}
+
+int Inverses(Matrix3DSoA m, Matrix3DSoA out, int count, bool* singular, int threads)
+{
+	std::atomic<int> singularCount(0);
+
+	ParallelFor(count, threads, INVERSE_CHUNK, [=, &singularCount](int begin, int end)
+	{
+		float r[9][BLOCK], o[9][BLOCK];
+		int flags[BLOCK];
+		int found = 0;
+
+		for (int start = begin; start < end; start += BLOCK)
+		{
+			int n = (end - start < BLOCK) ? end - start : BLOCK;
+			LoadSoA(m, start, n, r);
+			found += InverseBlock(r, n, o, flags);
+			StoreSoA(o, start, n, out);
+			CopySingular(flags, n, (singular != nullptr) ? singular + start : nullptr);
+		}
+
+		singularCount += found;
+	});
+
+	return singularCount;
+}
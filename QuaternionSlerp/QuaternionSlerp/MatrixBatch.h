@@ -0,0 +1,75 @@
+/*
+Title: Matrix Mathematics
+File Name: MatrixBatch.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "Matrix4D.h"
+
+// Multiplies count pairs of matrices: out[i] = l[i] * r[i].
+// out may be the same array as l or r.
+void MultiplyMatrices(const Matrix4D* l, const Matrix4D* r, Matrix4D* out, int count);
+
+// Composes a chain of transforms in place, replacing each matrix by the product of all the matrices up to it:
+//  m[i] becomes m[0] * m[1] * ... * m[i].
+// With m[0] the outermost transform, such as a root joint, every entry ends up as its full transform.
+void ComposeChain(Matrix4D* m, int count);
+
+// Returns the product of the whole chain, m[0] * m[1] * ... * m[count - 1], or the identity for an empty chain.
+Matrix4D MultiplyChain(const Matrix4D* m, int count);
+
+// Inverts count matrices, each by the method for its class: out[i] = Inverse(m[i], c[i]).
+// The classes can come from Classify, or be known from where the matrices came from, such as a skeleton's
+//  bind poses (rigid) or model matrices built from a scale, rotation and translation (affine).
+// out may be the same array as m.
+void Inverses(const Matrix4D* m, const MatrixClass* c, Matrix4D* out, int count);
+
+// Many 3x3 matrices stored as a structure of arrays (SoA), like QuaternionSoA:
+//  n[3 * j + i][k] is element (i, j) of matrix k, so n[0] to n[2] hold the first columns, and so on.
+struct Matrix3DSoA
+{
+	float* n[9];
+};
+
+// Copies count matrices between an array of Matrix3D and a Matrix3DSoA.
+void ToSoA(const Matrix3D* m, Matrix3DSoA out, int count);
+void FromSoA(Matrix3DSoA m, Matrix3D* out, int count);
+
+// Determinants and inverses of count 3x3 matrices in SoA form: out[i] = Determinant(m[i]) or out[i] = Inverse(m[i]).
+// Inverses treats a matrix as singular when its determinant is tiny compared with the lengths of its columns
+//  (less than a millionth of their product), writes the zero matrix for it instead of dividing by almost nothing,
+//  sets singular[i] to true (singular may be nullptr) and returns the number of singular matrices.
+// For inertia tensors, a zero inverse is the same as infinite inertia: the body doesn't rotate.
+// The work is split across up to threads threads (0 for one per hardware thread, see ParallelFor),
+//  though arrays under about 16K matrices always run on the calling thread. out may be the same arrays as m.
+// These only pay off when the matrices are kept in SoA form; shuffling an array of Matrix3D into it and back
+//  costs about as much as inverting each one with Inverse.
+void Determinants(Matrix3DSoA m, float* out, int count, int threads = 1);
+int Inverses(Matrix3DSoA m, Matrix3DSoA out, int count, bool* singular = nullptr, int threads = 1);
+
+// Closed-form adjugates and cofactor matrices over arrays, the same as Adjugate and CofactorMatrix:
+//  out[i] = Adjugate(m[i]) or out[i] = CofactorMatrix(m[i]). out may be the same array as m.
+void Adjugates(const Matrix3D* m, Matrix3D* out, int count);
+void Adjugates(const Matrix4D* m, Matrix4D* out, int count);
+void CofactorMatrices(const Matrix3D* m, Matrix3D* out, int count);
+void CofactorMatrices(const Matrix4D* m, Matrix4D* out, int count);
+
+// Writes the matrix that transforms normals for each model matrix: the cofactor matrix of its upper left 3x3.
+// That is the inverse transpose times the determinant, so normals come out scaled (and flipped for mirroring
+//  transforms, where the determinant is negative), but it needs no division and works for singular matrices.
+// Renormalize the normals after transforming them, as with the inverse transpose whenever there is scaling.
+void NormalMatrices(const Matrix4D* m, Matrix3D* out, int count);
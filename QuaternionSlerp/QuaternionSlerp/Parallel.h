@@ -0,0 +1,63 @@
+/*
+Title: Quaternion Math
+File Name: Parallel.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <thread>
+#include <vector>
+
+// Splits the range [0, count) into contiguous pieces and calls body(begin, end) once for each piece,
+//  running the pieces on separate threads. Returns when every piece is done.
+// threads is the most threads to use, with 0 meaning one per hardware thread, and 1 running body(0, count)
+//  on the calling thread. Pieces are never smaller than minChunk, since starting a thread costs
+//  tens of microseconds, which is only worth it when each one gets enough work.
+// Every piece must be safe to run at the same time as the others, e.g. by writing to separate outputs.
+template <typename Body>
+void ParallelFor(int count, int threads, int minChunk, Body body)
+{
+	if (threads <= 0)
+	{
+		threads = (int)std::thread::hardware_concurrency();
+	}
+
+	int most = (minChunk > 0) ? count / minChunk : count;
+	threads = (threads < most) ? threads : most;
+
+	if (threads <= 1)
+	{
+		body(0, count);
+		return;
+	}
+
+	// The calling thread takes the first piece instead of waiting idle
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	for (int i = 1; i < threads; i++)
+	{
+		int begin = (int)((long long)count * i / threads);
+		int end = (int)((long long)count * (i + 1) / threads);
+		workers.emplace_back([=]() { body(begin, end); });
+	}
+
+	body(0, (int)((long long)count / threads));
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
@@ -0,0 +1,115 @@
+/*
+Title: Quaternion Math
+File Name: PoseEvaluator.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "PoseEvaluator.h"
+#include "QuaternionBatch.h"
+
+#include <math.h>
+
+// Joints are sampled in blocks of this many, as in RotationTrack::Evaluate
+static const int POSE_BLOCK = 64;
+
+// Normalizes the n summed rotations in place
+static void NormalizeRotations(float* __restrict w, float* __restrict x, float* __restrict y, float* __restrict z, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		float invLength = 1.0f / sqrtf(w[i] * w[i] + x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+
+		w[i] *= invLength;
+		x[i] *= invLength;
+		y[i] *= invLength;
+		z[i] *= invLength;
+	}
+}
+
+PoseEvaluator::PoseEvaluator(int threads)
+	: pool(threads)
+{
+	buffers.resize(pool.Size());
+}
+
+void PoseEvaluator::Evaluate(const PoseJob* jobs, int count)
+{
+	pool.Run(count, [this, jobs](int item, int thread)
+	{
+		Evaluate(jobs[item], buffers[thread]);
+	});
+}
+
+void PoseEvaluator::Evaluate(const PoseJob& job, PoseBuffer& buffer)
+{
+	int jointCount = (int)job.skeleton->parents.size();
+
+	buffer.w.assign(jointCount, 0.0f);
+	buffer.x.assign(jointCount, 0.0f);
+	buffer.y.assign(jointCount, 0.0f);
+	buffer.z.assign(jointCount, 0.0f);
+	buffer.translations.assign(jointCount, Vector3D(0, 0, 0));
+	buffer.local.resize(jointCount);
+
+	float aw[POSE_BLOCK], ax[POSE_BLOCK], ay[POSE_BLOCK], az[POSE_BLOCK];
+	float bw[POSE_BLOCK], bx[POSE_BLOCK], by[POSE_BLOCK], bz[POSE_BLOCK];
+	float ow[POSE_BLOCK], ox[POSE_BLOCK], oy[POSE_BLOCK], oz[POSE_BLOCK];
+	float u[POSE_BLOCK];
+	QuaternionSoA a = { aw, ax, ay, az };
+	QuaternionSoA b = { bw, bx, by, bz };
+	QuaternionSoA o = { ow, ox, oy, oz };
+	float totalWeight = 0;
+
+	for (int l = 0; l < job.layerCount; l++)
+	{
+		const PoseLayer& layer = job.layers[l];
+		const AnimationClip& clip = *layer.clip;
+		totalWeight += layer.weight;
+
+		for (int start = 0; start < jointCount; start += POSE_BLOCK)
+		{
+			int n = (jointCount - start < POSE_BLOCK) ? jointCount - start : POSE_BLOCK;
+
+			for (int i = 0; i < n; i++)
+			{
+				const RotationTrack& track = clip.rotations[start + i];
+				int keyCount = (int)track.keys.size();
+				int segment = FindSegment(track.times.data(), keyCount, layer.time);
+				int next = (segment + 1 < keyCount) ? segment + 1 : segment;
+				Quaternion qa = track.keys[segment], qb = track.keys[next];
+
+				aw[i] = qa.w; ax[i] = qa.x; ay[i] = qa.y; az[i] = qa.z;
+				bw[i] = qb.w; bx[i] = qb.x; by[i] = qb.y; bz[i] = qb.z;
+				u[i] = SegmentFraction(track.times.data(), keyCount, segment, layer.time);
+
+				buffer.translations[start + i] = buffer.translations[start + i] + layer.weight * clip.translations[start + i];
+			}
+
+			SlerpBatch(a, b, u, o, n);
+			QuaternionSoA sum = { &buffer.w[start], &buffer.x[start], &buffer.y[start], &buffer.z[start] };
+			AddAlignedBatch(sum, o, layer.weight, n);
+		}
+	}
+
+	NormalizeRotations(buffer.w.data(), buffer.x.data(), buffer.y.data(), buffer.z.data(), jointCount);
+
+	for (int i = 0; i < jointCount; i++)
+	{
+		buffer.local[i] = JointTransform(Quaternion(buffer.w[i], buffer.x[i], buffer.y[i], buffer.z[i]),
+			buffer.translations[i] / totalWeight);
+	}
+
+	ComputeWorldTransforms(*job.skeleton, buffer.local.data(), job.world);
+}
@@ -0,0 +1,76 @@
+/*
+Title: Quaternion Math
+File Name: PoseEvaluator.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "AnimationTrack.h"
+#include "Skeleton.h"
+#include "ThreadPool.h"
+
+#include <vector>
+
+// One clip playing on a character, at a time in the clip and with a weight for blending it with the character's other layers
+struct PoseLayer
+{
+	const AnimationClip* clip;
+	float time;
+	float weight;
+};
+
+// The pose of one character: its skeleton, the layers blended to make its local pose,
+//  and where to write the world transform of each of its joints, in skeleton order.
+// Every clip must have a track and a translation for each joint of the skeleton.
+struct PoseJob
+{
+	const Skeleton* skeleton;
+	const PoseLayer* layers;
+	int layerCount;
+	JointTransform* world;
+};
+
+// Evaluates the poses of many characters each frame across a ThreadPool.
+// For each character, every layer's tracks are sampled with SlerpBatch into a pose buffer that holds each component
+//  of the joint rotations in its own array, and added to the pose with the layer's weight, flipped to the same side
+//  as the rotations already there. The sums are normalized, and scaled back for the translations,
+//  which gives the local pose, and ComputeWorldTransforms turns that into world transforms.
+// The pose buffers are kept for each thread and reused, so after the first few frames nothing is allocated.
+class PoseEvaluator
+{
+public:
+	// threads as for ThreadPool
+	explicit PoseEvaluator(int threads = 0);
+
+	// Evaluates count characters, each on one thread, with threads that finish early taking characters from the others.
+	// The layer weights of each character must add up to more than 0.
+	// The world arrays of the jobs must not overlap.
+	void Evaluate(const PoseJob* jobs, int count);
+
+private:
+	// The scratch memory of one thread
+	struct PoseBuffer
+	{
+		std::vector<float> w, x, y, z;
+		std::vector<Vector3D> translations;
+		std::vector<JointTransform> local;
+	};
+
+	void Evaluate(const PoseJob& job, PoseBuffer& buffer);
+
+	ThreadPool pool;
+	std::vector<PoseBuffer> buffers;
+};
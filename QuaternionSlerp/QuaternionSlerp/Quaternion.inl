@@ -0,0 +1,324 @@
+/*
+Title: Quaternion Math
+File Name: Quaternion.inl
+Author: Parth Contractor
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Definitions of the functions declared in Quaternion.h (see MATH_HEADER_ONLY in helpers.h).
+#pragma once
+
+// The magnitude is the obtained the getting the square root of the norm of the Quaternion
+template <typename T>
+T Magnitude(QuaternionT<T> q) noexcept
+{
+	return (std::sqrt(Norm(q)));
+}
+
+// The division between two Quaternion is obtained by
+// calculating the norm of the divisor
+// multiplying the two quaternions and
+// dividing the resultant quaternion by norm of the divisor
+template <typename T>
+QuaternionT<T> operator/(QuaternionT<T> q, QuaternionT<T> r) noexcept
+{
+	T norm = Norm(r);
+
+	QuaternionT<T> x = q * r;
+
+	return QuaternionT<T>(x / norm);
+}
+
+// Normalize the Quaternion by dividing it with the magnitude
+template <typename T>
+QuaternionT<T> Normalize(QuaternionT<T> q) noexcept
+{
+	return (q / Magnitude(q));
+}
+
+// The inverse of a quaternion is obtained by dividing the Conjugate with the Norm of the Quaternion
+template <typename T>
+QuaternionT<T> Inverse(QuaternionT<T> q) noexcept
+{
+	return(Conjugate(q) / Norm(q));
+}
+
+// To calculate the angle between two quaternions
+// Obtain the cosine of the angle by calculating the dot product of two quaternions
+// and dividing it by the product of the magnitude of both the quaternions
+// calculate the cosine inverse of the result to obtain angle
+template <typename T>
+T AngleBetweenQuaternions(QuaternionT<T> q, QuaternionT<T> r) noexcept
+{
+	T cosOfAngle = Dot(q, r) / (Magnitude(q) * Magnitude(r));
+
+	return (std::acos(cosOfAngle));
+}
+
+// The Quaternion for the rotation is obtained by
+// creating a quaternion from the vector to get direction and the angle provided
+MATH_INLINE Quaternion Rotation(Vector3D v, float a) noexcept
+{
+	v = Normalize(v);
+
+	return Quaternion(cos(a / 2), (sin(a / 2) * v));
+}
+
+// The diagonal of a rotation matrix gives the squares of the quaternion components:
+//  1 + m00 + m11 + m22 = 4w^2, 1 + m00 - m11 - m22 = 4x^2, 1 - m00 + m11 - m22 = 4y^2, 1 - m00 - m11 + m22 = 4z^2
+// and the off-diagonal elements give their pairwise products:
+//  m21 - m12 = 4wx, m02 - m20 = 4wy, m10 - m01 = 4wz, m01 + m10 = 4xy, m02 + m20 = 4xz, m12 + m21 = 4yz
+// So for any component c, the quaternion is 4c * q = (the diagonal sum 4c^2, and the three products that contain c).
+// We pick the c with the largest diagonal sum, which means we never scale by a component close to 0,
+//  and normalizing that 4-vector divides out the 4c (or -4c, to keep w >= 0).
+// The choice only picks between values that are all computed anyway, so compilers turn it into selects, not branches.
+MATH_INLINE Quaternion Rotation(const Matrix3D& m) noexcept
+{
+	float tw = 1 + m(0, 0) + m(1, 1) + m(2, 2);
+	float tx = 1 + m(0, 0) - m(1, 1) - m(2, 2);
+	float ty = 1 - m(0, 0) + m(1, 1) - m(2, 2);
+	float tz = 1 - m(0, 0) - m(1, 1) + m(2, 2);
+
+	float wx = m(2, 1) - m(1, 2);
+	float wy = m(0, 2) - m(2, 0);
+	float wz = m(1, 0) - m(0, 1);
+	float xy = m(0, 1) + m(1, 0);
+	float xz = m(0, 2) + m(2, 0);
+	float yz = m(1, 2) + m(2, 1);
+
+	bool useW = (tw >= tx) & (tw >= ty) & (tw >= tz);
+	bool useX = !useW & (tx >= ty) & (tx >= tz);
+	bool useY = !useW & !useX & (ty >= tz);
+
+	Quaternion q = useW ? Quaternion(tw, wx, wy, wz)
+		: useX ? Quaternion(wx, tx, xy, xz)
+		: useY ? Quaternion(wy, xy, ty, yz)
+		: Quaternion(wz, xz, yz, tz);
+
+	return Normalize((q.w < 0) ? -q : q);
+}
+
+MATH_INLINE Quaternion Rotation(const Matrix4D& m) noexcept
+{
+	return Rotation(Matrix3D(m(0, 0), m(0, 1), m(0, 2),
+		m(1, 0), m(1, 1), m(1, 2),
+		m(2, 0), m(2, 1), m(2, 2)));
+}
+
+// The slerp moves a point in space from one position to another spherically using
+// the general formula p' = p1 + t(p2 - p1) where p' is the current position,
+// p1 is the original position, p2 is the final position, and time is represented by t
+// All of the intermediate values are calculated in T, so a float Slerp stays in float from start to end.
+template <typename T>
+QuaternionT<T> Slerp(QuaternionT<T> a, QuaternionT<T> b, typename QuaternionT<T>::Scalar t) noexcept
+{
+	QuaternionT<T> q = QuaternionT<T>();
+
+	// Calculate angle between them
+	T cosHalfTheta = (a.w * b.w) + (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+
+	if (std::abs(cosHalfTheta) >= T(1))
+	{
+		q.w = a.w;
+		q.x = a.x;
+		q.y = a.y;
+		q.z = a.z;
+
+		return q;
+	}
+
+	// Calculate temporary values
+	// 1 - cos^2 is factored as (1 - cos)(1 + cos): when a and b are close, cos^2 rounds to almost 1 in float,
+	//  and subtracting it from 1 would leave only a few correct bits of sin.
+	T halfTheta = std::acos(cosHalfTheta);
+	T sinHalfTheta = std::sqrt((T(1) - cosHalfTheta) * (T(1) + cosHalfTheta));
+
+	// if theta = 0 degrees then a and b are so close that lerp is as good as slerp,
+	//  and the ratios below would divide by almost nothing
+	if (std::abs(sinHalfTheta) < T(0.001) && cosHalfTheta > 0)
+	{
+		q.w = (a.w * (1 - t) + b.w * t);
+		q.x = (a.x * (1 - t) + b.x * t);
+		q.y = (a.y * (1 - t) + b.y * t);
+		q.z = (a.z * (1 - t) + b.z * t);
+
+		return q;
+	}
+
+	// if theta = 180 degrees then result is not fully defined
+	// we could rotate around any axis normal to a or b
+	if (std::abs(sinHalfTheta) < T(0.001))
+	{
+		q.w = (a.w * T(0.5) + b.w * T(0.5));
+		q.x = (a.x * T(0.5) + b.x * T(0.5));
+		q.y = (a.y * T(0.5) + b.y * T(0.5));
+		q.z = (a.z * T(0.5) + b.z * T(0.5));
+
+		return q;
+	}
+
+	T ratioA = std::sin((1 - t) * halfTheta) / sinHalfTheta;
+	T ratioB = std::sin(t * halfTheta) / sinHalfTheta;
+
+	// Calculate Quaternion
+	q.w = (a.w * ratioA + b.w * ratioB);
+	q.x = (a.x * ratioA + b.x * ratioB);
+	q.y = (a.y * ratioA + b.y * ratioB);
+	q.z = (a.z * ratioA + b.z * ratioB);
+
+	return q;
+}
+
+// Slerp<Policy> picks one of the SlerpWithPolicy overloads below by the type of its last argument.
+// These helpers are not static: Slerp<Policy> has external linkage, and with MATH_HEADER_ONLY every file that includes
+//  this one would otherwise call its own private copy of them from the same Slerp<Policy>, which breaks the one definition rule.
+template <typename T>
+QuaternionT<T> SlerpWithPolicy(QuaternionT<T> a, QuaternionT<T> b, T t, SlerpExact)
+{
+	return Slerp(a, b, t);
+}
+
+// Both approximations below are fitted for quaternions at most 90 degrees apart on the 4D sphere (Dot(a, b) >= 0).
+// Each one only works out the two ratios that a and b are scaled by, as in Slerp.
+// Slerp from a to b passes through the midpoint m = (a + b) / |a + b| at t = 0.5,
+//  so for Dot(a, b) < 0 we interpolate over the half of the arc that t falls in, which is always under 90 degrees,
+//  and then fold the ratio of m back into the ratios of a and b.
+// The special cases are tested without acos or sqrt:
+//  sinHalfTheta < 0.001 is the same as cosHalfTheta^2 > 1 - 0.001^2.
+template <typename T, typename Ratios>
+QuaternionT<T> SlerpApproximate(QuaternionT<T> a, QuaternionT<T> b, T t, Ratios ratios)
+{
+	T cosHalfTheta = (a.w * b.w) + (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+
+	if (std::abs(cosHalfTheta) >= T(1))
+	{
+		return a;
+	}
+
+	if (cosHalfTheta * cosHalfTheta > T(1) - T(0.000001) && cosHalfTheta > 0)
+	{
+		return QuaternionT<T>(a.w * (1 - t) + b.w * t, a.x * (1 - t) + b.x * t,
+			a.y * (1 - t) + b.y * t, a.z * (1 - t) + b.z * t);
+	}
+
+	if (cosHalfTheta * cosHalfTheta > T(1) - T(0.000001))
+	{
+		return QuaternionT<T>(a.w * T(0.5) + b.w * T(0.5), a.x * T(0.5) + b.x * T(0.5),
+			a.y * T(0.5) + b.y * T(0.5), a.z * T(0.5) + b.z * T(0.5));
+	}
+
+	T ratioA, ratioB;
+	if (cosHalfTheta < 0)
+	{
+		// |a + b|^2 = 2 + 2 * Dot(a, b) for unit quaternions
+		T invLength = 1 / std::sqrt(2 + 2 * cosHalfTheta);
+		T cosHalf = (1 + cosHalfTheta) * invLength;
+		T ratioM;
+
+		if (t < T(0.5))
+		{
+			ratios(cosHalf, 2 * t, ratioA, ratioM);
+			ratioA += ratioM * invLength;
+			ratioB = ratioM * invLength;
+		}
+		else
+		{
+			ratios(cosHalf, 2 * t - 1, ratioM, ratioB);
+			ratioA = ratioM * invLength;
+			ratioB += ratioM * invLength;
+		}
+	}
+	else
+	{
+		ratios(cosHalfTheta, t, ratioA, ratioB);
+	}
+
+	return QuaternionT<T>(a.w * ratioA + b.w * ratioB, a.x * ratioA + b.x * ratioB,
+		a.y * ratioA + b.y * ratioB, a.z * ratioA + b.z * ratioB);
+}
+
+// sin(t * theta) / sin(theta) is expanded as a power series in (cos(theta) - 1), following David Eberly,
+//  "A Fast and Accurate Algorithm for Computing SLERP" (2011):
+//  the first term is t, and each term i is the previous one times (t^2 - i^2) / (i(2i + 1)) * (cos(theta) - 1).
+// The series is cut off after 8 terms, and the last term is scaled by mu to make up for the missing ones.
+// The largest error in the ratio for angles up to 90 degrees is 2e-5.
+template <typename T>
+T SinRatio(T t, T cosTheta)
+{
+	static const T mu = T(1.85298109240830);
+	static const T u[8] = { T(1) / (1 * 3), T(1) / (2 * 5), T(1) / (3 * 7), T(1) / (4 * 9),
+		T(1) / (5 * 11), T(1) / (6 * 13), T(1) / (7 * 15), mu / (8 * 17) };
+	static const T v[8] = { T(1) / 3, T(2) / 5, T(3) / 7, T(4) / 9,
+		T(5) / 11, T(6) / 13, T(7) / 15, mu * 8 / 17 };
+
+	T xm1 = cosTheta - 1;
+	T tt = t * t;
+	T term = t;
+	T sum = t;
+	for (int i = 0; i < 8; i++)
+	{
+		term *= (u[i] * tt - v[i]) * xm1;
+		sum += term;
+	}
+
+	return sum;
+}
+
+// Measured on 1M random unit pairs against Slerp: see Quaternion.h for the error and speedup.
+template <typename T>
+QuaternionT<T> SlerpWithPolicy(QuaternionT<T> a, QuaternionT<T> b, T t, SlerpPolynomial)
+{
+	return SlerpApproximate(a, b, t, [](T cosTheta, T s, T& ratioA, T& ratioB)
+	{
+		ratioA = SinRatio(1 - s, cosTheta);
+		ratioB = SinRatio(s, cosTheta);
+	});
+}
+
+// Normalized lerp moves along the same arc as Slerp but too slowly near the ends and too quickly in the middle.
+// Remapping t with the cubic t + k * t(t - 0.5)(t - 1), with k fitted as a function of the angle,
+//  takes out most of that difference (coefficients from Arseny Kapoulkine, "Approximating slerp", 2015).
+// The length of (1 - s) * a + s * b for unit a and b only depends on s and the angle, so we never build the lerp itself.
+template <typename T>
+QuaternionT<T> SlerpWithPolicy(QuaternionT<T> a, QuaternionT<T> b, T t, SlerpCorrectedNlerp)
+{
+	return SlerpApproximate(a, b, t, [](T cosTheta, T s, T& ratioA, T& ratioB)
+	{
+		T d = cosTheta;
+		T A = T(1.0904) + d * (T(-3.2452) + d * (T(3.55645) - d * T(1.43519)));
+		T B = T(0.848013) + d * (T(-1.06021) + d * T(0.215638));
+		T k = A * (s - T(0.5)) * (s - T(0.5)) + B;
+		T corrected = s + s * (s - T(0.5)) * (s - 1) * k;
+
+		T r = 1 - corrected;
+		T invLength = 1 / std::sqrt(r * r + corrected * corrected + 2 * r * corrected * cosTheta);
+		ratioA = r * invLength;
+		ratioB = corrected * invLength;
+	});
+}
+
+template <typename Policy, typename T>
+QuaternionT<T> Slerp(QuaternionT<T> a, QuaternionT<T> b, typename QuaternionT<T>::Scalar t) noexcept
+{
+	return SlerpWithPolicy(a, b, t, Policy());
+}
+
+// Prints out the quaternion in the format (w, x, y, z)
+template <typename T>
+std::ostream& operator<<(std::ostream& os, QuaternionT<T> q)
+{
+	os << "(" << q.w << ", " << q.x << ", " << q.y << ", " << q.z << ")";
+	return os;
+}
@@ -0,0 +1,234 @@
+/*
+Title: Quaternion Math
+File Name: QuaternionAverage.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "QuaternionAverage.h"
+
+#include <math.h>
+
+// Joints are averaged in blocks of this many, with their sums kept in local arrays
+static const int AVERAGE_BLOCK = 64;
+
+// The 10 different elements of a symmetric 4x4 matrix, m[0] to m[9] being
+//  (0,0) (0,1) (0,2) (0,3) (1,1) (1,2) (1,3) (2,2) (2,3) (3,3), each for a block of joints
+struct SymmetricBlock
+{
+	float m[10][AVERAGE_BLOCK];
+};
+
+// Adds weight * q q^T to the matrices of n joints
+static void AddOuterProduct(SymmetricBlock& __restrict s,
+	const float* __restrict qw, const float* __restrict qx, const float* __restrict qy, const float* __restrict qz,
+	float weight, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		float w = weight * qw[i], x = weight * qx[i], y = weight * qy[i], z = weight * qz[i];
+
+		s.m[0][i] += w * qw[i]; s.m[1][i] += w * qx[i]; s.m[2][i] += w * qy[i]; s.m[3][i] += w * qz[i];
+		s.m[4][i] += x * qx[i]; s.m[5][i] += x * qy[i]; s.m[6][i] += x * qz[i];
+		s.m[7][i] += y * qy[i]; s.m[8][i] += y * qz[i];
+		s.m[9][i] += z * qz[i];
+	}
+}
+
+// Replaces the symmetric matrix (a b c d / b e f g / c f h i / d g i j) by its square, divided by its trace
+//  so that the elements stay around 1 however many times it is squared.
+static inline void SquareSymmetric(float& a, float& b, float& c, float& d, float& e,
+	float& f, float& g, float& h, float& i, float& j)
+{
+	float a2 = a * a + b * b + c * c + d * d;
+	float b2 = a * b + b * e + c * f + d * g;
+	float c2 = a * c + b * f + c * h + d * i;
+	float d2 = a * d + b * g + c * i + d * j;
+	float e2 = b * b + e * e + f * f + g * g;
+	float f2 = b * c + e * f + f * h + g * i;
+	float g2 = b * d + e * g + f * i + g * j;
+	float h2 = c * c + f * f + h * h + i * i;
+	float i2 = c * d + f * g + h * i + i * j;
+	float j2 = d * d + g * g + i * i + j * j;
+
+	float invTrace = 1.0f / (a2 + e2 + h2 + j2);
+	a = a2 * invTrace; b = b2 * invTrace; c = c2 * invTrace; d = d2 * invTrace; e = e2 * invTrace;
+	f = f2 * invTrace; g = g2 * invTrace; h = h2 * invTrace; i = i2 * invTrace; j = j2 * invTrace;
+}
+
+// Normalizes the sums of n joints in place. A sum of exactly 0, which only comes from weights that are all 0,
+//  becomes the identity instead of dividing by 0.
+static void NormalizeSums(float* __restrict w, float* __restrict x, float* __restrict y, float* __restrict z, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		float norm = w[i] * w[i] + x[i] * x[i] + y[i] * y[i] + z[i] * z[i];
+		w[i] += (norm > 0.0f) ? 0.0f : 1.0f;
+		norm += (norm > 0.0f) ? 0.0f : 1.0f;
+
+		float invLength = 1.0f / sqrtf(norm);
+		w[i] *= invLength;
+		x[i] *= invLength;
+		y[i] *= invLength;
+		z[i] *= invLength;
+	}
+}
+
+// Turns the normalized sums (w, x, y, z) of n joints into the dominant eigenvectors of their matrices s.
+// After 6 squarings M^64 is close to v v^T for the eigenvector v of the largest eigenvalue, with the others scaled
+//  down by (lambda_k / lambda_1)^64, so each of its columns is v times one component of v.
+// The column with the largest diagonal element is the one whose component is largest, at least 1/2,
+//  which is applied to M^64 once more to take out what is left of the other eigenvectors.
+// The result is flipped to the same side as the normalized sum.
+static void DominantEigenvectors(SymmetricBlock& __restrict s, float* __restrict w, float* __restrict x,
+	float* __restrict y, float* __restrict z, int n)
+{
+	for (int k = 0; k < n; k++)
+	{
+		float a = s.m[0][k], b = s.m[1][k], c = s.m[2][k], d = s.m[3][k], e = s.m[4][k];
+		float f = s.m[5][k], g = s.m[6][k], h = s.m[7][k], i = s.m[8][k], j = s.m[9][k];
+
+		// Divides by the trace first, so that small weights don't underflow when squared.
+		// A trace of 0, which only comes from weights that are all 0, would give NaNs, so that matrix becomes
+		//  diag(1, 0, 0, 0) instead, whose eigenvector is the identity, the same as NormalizeSums gives.
+		float trace = a + e + h + j;
+		float empty = (trace > 0.0f) ? 0.0f : 1.0f;
+		float invTrace = 1.0f / (trace + empty);
+		a = a * invTrace + empty; b *= invTrace; c *= invTrace; d *= invTrace; e *= invTrace;
+		f *= invTrace; g *= invTrace; h *= invTrace; i *= invTrace; j *= invTrace;
+
+		// Written out rather than looped, since the compiler leaves a loop over the squarings as a loop, which isn't vectorized
+		SquareSymmetric(a, b, c, d, e, f, g, h, i, j);
+		SquareSymmetric(a, b, c, d, e, f, g, h, i, j);
+		SquareSymmetric(a, b, c, d, e, f, g, h, i, j);
+		SquareSymmetric(a, b, c, d, e, f, g, h, i, j);
+		SquareSymmetric(a, b, c, d, e, f, g, h, i, j);
+		SquareSymmetric(a, b, c, d, e, f, g, h, i, j);
+
+		// Picks a column by the largest diagonal element, with 0 or 1 flags instead of branches
+		float vw = a, vx = b, vy = c, vz = d, largest = a;
+		float second = (e > largest) ? 1.0f : 0.0f;
+		vw += second * (b - vw); vx += second * (e - vx); vy += second * (f - vy); vz += second * (g - vz);
+		largest += second * (e - largest);
+		float third = (h > largest) ? 1.0f : 0.0f;
+		vw += third * (c - vw); vx += third * (f - vx); vy += third * (h - vy); vz += third * (i - vz);
+		largest += third * (h - largest);
+		float fourth = (j > largest) ? 1.0f : 0.0f;
+		vw += fourth * (d - vw); vx += fourth * (g - vx); vy += fourth * (i - vy); vz += fourth * (j - vz);
+
+		float rw = a * vw + b * vx + c * vy + d * vz;
+		float rx = b * vw + e * vx + f * vy + g * vz;
+		float ry = c * vw + f * vx + h * vy + i * vz;
+		float rz = d * vw + g * vx + i * vy + j * vz;
+
+		float dot = rw * w[k] + rx * x[k] + ry * y[k] + rz * z[k];
+		float invLength = 1.0f / sqrtf(rw * rw + rx * rx + ry * ry + rz * rz);
+		invLength = (dot < 0.0f) ? -invLength : invLength;
+
+		w[k] = rw * invLength; x[k] = rx * invLength; y[k] = ry * invLength; z[k] = rz * invLength;
+	}
+}
+
+void AverageQuaternions(const QuaternionSoA* layers, const float* weights, int layerCount, QuaternionSoA out, int count,
+	AverageMethod method)
+{
+	float sw[AVERAGE_BLOCK], sx[AVERAGE_BLOCK], sy[AVERAGE_BLOCK], sz[AVERAGE_BLOCK];
+	QuaternionSoA sum = { sw, sx, sy, sz };
+	SymmetricBlock s;
+	bool eigenvector = (method == AverageMethod::Eigenvector);
+
+	for (int start = 0; start < count; start += AVERAGE_BLOCK)
+	{
+		int n = (count - start < AVERAGE_BLOCK) ? count - start : AVERAGE_BLOCK;
+
+		for (int i = 0; i < n; i++)
+		{
+			sw[i] = sx[i] = sy[i] = sz[i] = 0.0f;
+		}
+		if (eigenvector)
+		{
+			for (int e = 0; e < 10; e++)
+			{
+				for (int i = 0; i < n; i++)
+				{
+					s.m[e][i] = 0.0f;
+				}
+			}
+		}
+
+		for (int l = 0; l < layerCount; l++)
+		{
+			const QuaternionSoA& q = layers[l];
+
+			QuaternionSoA block = { q.w + start, q.x + start, q.y + start, q.z + start };
+			AddAlignedBatch(sum, block, weights[l], n);
+			if (eigenvector)
+			{
+				AddOuterProduct(s, q.w + start, q.x + start, q.y + start, q.z + start, weights[l], n);
+			}
+		}
+
+		NormalizeSums(sw, sx, sy, sz, n);
+		if (eigenvector)
+		{
+			DominantEigenvectors(s, sw, sx, sy, sz, n);
+		}
+
+		for (int i = 0; i < n; i++)
+		{
+			out.w[start + i] = sw[i];
+			out.x[start + i] = sx[i];
+			out.y[start + i] = sy[i];
+			out.z[start + i] = sz[i];
+		}
+	}
+}
+
+// A single joint is a batch of one, with each input as a layer of one quaternion
+Quaternion AverageQuaternions(const Quaternion* q, const float* weights, int count, AverageMethod method)
+{
+	float sw[1] = { 0 }, sx[1] = { 0 }, sy[1] = { 0 }, sz[1] = { 0 };
+	QuaternionSoA sum = { sw, sx, sy, sz };
+	SymmetricBlock s;
+	bool eigenvector = (method == AverageMethod::Eigenvector);
+
+	// Only the first lane of s is used, and only by the eigenvector method
+	if (eigenvector)
+	{
+		for (int e = 0; e < 10; e++)
+		{
+			s.m[e][0] = 0.0f;
+		}
+	}
+
+	for (int l = 0; l < count; l++)
+	{
+		float qw[1] = { q[l].w }, qx[1] = { q[l].x }, qy[1] = { q[l].y }, qz[1] = { q[l].z };
+		QuaternionSoA layer = { qw, qx, qy, qz };
+
+		AddAlignedBatch(sum, layer, weights[l], 1);
+		if (eigenvector)
+		{
+			AddOuterProduct(s, qw, qx, qy, qz, weights[l], 1);
+		}
+	}
+
+	NormalizeSums(sw, sx, sy, sz, 1);
+	if (eigenvector)
+	{
+		DominantEigenvectors(s, sw, sx, sy, sz, 1);
+	}
+
+	return Quaternion(sw[0], sx[0], sy[0], sz[0]);
+}
@@ -0,0 +1,47 @@
+/*
+Title: Quaternion Math
+File Name: QuaternionAverage.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "QuaternionBatch.h"
+
+// How AverageQuaternions blends rotations.
+// NormalizedSum adds up the weighted quaternions, each flipped to the same side as the sum so far, and normalizes.
+//  It is as cheap as a blend can be, and close to the true average when the rotations are close together,
+//  but the flips depend on the order of the inputs when they are far apart.
+// Eigenvector is the average of F. Landis Markley et al., "Averaging Quaternions" (2007): the unit quaternion q
+//  that maximizes the sum of w[i] Dot(q, q[i])^2, which is the eigenvector of M = sum of w[i] q[i] q[i]^T
+//  with the largest eigenvalue. It doesn't depend on the order or on the signs of the inputs.
+//  The eigenvector is found by raising M to the 64th power with 6 squarings, taking its largest column
+//  and applying M^64 to that once more. When the largest eigenvalue is close to the next one, which happens when
+//  the rotations are spread all around, the average itself is poorly defined, and this converges less.
+enum class AverageMethod { NormalizedSum, Eigenvector };
+
+// Returns the weighted average of count rotations. The weights must not be negative.
+// If they are all 0, or count is 0, both methods return the identity.
+// For rotations within about 30 degrees of each other, the two methods agree to within 0.01 radians,
+//  and Eigenvector is within 1e-6 radians of the exact eigenvector.
+Quaternion AverageQuaternions(const Quaternion* q, const float* weights, int count, AverageMethod method = AverageMethod::NormalizedSum);
+
+// Averages count joints over layerCount layers at once:
+//  out[i] = AverageQuaternions of (layers[0][i], layers[1][i], ...) with weights (weights[0], weights[1], ...).
+// One pass over each layer adds it into the sums of every joint, and the sums are turned into averages in a loop
+//  over the joints without branches, so both are vectorized.
+// out may be the same arrays as one of the layers, but must not partially overlap any of them.
+void AverageQuaternions(const QuaternionSoA* layers, const float* weights, int layerCount, QuaternionSoA out, int count,
+	AverageMethod method = AverageMethod::NormalizedSum);
@@ -0,0 +1,432 @@
+/*
+Title: Quaternion Math
+File Name: QuaternionBatch.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "QuaternionBatch.h"
+#include "Parallel.h"
+
+// The kernels below are written as plain loops over the SoA arrays, with no branches and no calls
+//  into the math library in the loop body, so that the compiler can turn each of them into
+//  SSE (4 lanes), AVX2 (8 lanes) or AVX-512 (16 lanes) code depending on the target it is built for.
+// Ternary operators are used to pick between results; compilers turn these into blend/select instructions.
+// GCC and Clang only do that when they may assume math functions don't set errno and floating point
+//  operations don't trap, which is why CMakeLists.txt adds -fno-math-errno and -fno-trapping-math.
+
+static const float PI = 3.14159265358979f;
+static const float HALF_PI = 1.57079632679490f;
+
+// acos(x) for x in [-1, 1], from Abramowitz and Stegun 4.4.46.
+// The polynomial is accurate to 2e-8 on [0, 1]; negative values use acos(x) = pi - acos(-x).
+static inline float BatchAcos(float x)
+{
+	float a = fabsf(x);
+	float p = -0.0012624911f;
+	p = p * a + 0.0066700901f;
+	p = p * a - 0.0170881256f;
+	p = p * a + 0.0308918810f;
+	p = p * a - 0.0501743046f;
+	p = p * a + 0.0889789874f;
+	p = p * a - 0.2145988016f;
+	p = p * a + 1.5707963050f;
+	float r = sqrtf(1.0f - a) * p;
+
+	return (x < 0.0f) ? PI - r : r;
+}
+
+// sin(x) for x in [0, pi].
+// sin is symmetric around pi/2, so we fold the input into [0, pi/2] and evaluate
+//  the Taylor series up to x^11, whose error there is below 6e-8.
+static inline float BatchSin(float x)
+{
+	x = (x > HALF_PI) ? PI - x : x;
+	float x2 = x * x;
+	float p = -2.5052108e-8f;
+	p = p * x2 + 2.7557319e-6f;
+	p = p * x2 - 1.9841270e-4f;
+	p = p * x2 + 8.3333333e-3f;
+	p = p * x2 - 1.6666667e-1f;
+	p = p * x2 + 1.0f;
+
+	return x * p;
+}
+
+void ToSoA(const Quaternion* q, QuaternionSoA out, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		out.w[i] = q[i].w;
+		out.x[i] = q[i].x;
+		out.y[i] = q[i].y;
+		out.z[i] = q[i].z;
+	}
+}
+
+void FromSoA(QuaternionSoA q, Quaternion* out, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		out[i] = Quaternion(q.w[i], q.x[i], q.y[i], q.z[i]);
+	}
+}
+
+// This is the same calculation as the scalar Slerp, one lane per quaternion pair.
+// Instead of returning early for the two special cases, every lane computes the general
+//  ratios and then replaces them with (1, 0), (1 - t, t) or (0.5, 0.5) where a special case applies.
+// The arrays are passed separately and marked __restrict (understood by GCC, Clang and MSVC);
+//  otherwise the compiler would have to prove at run time that none of the 13 arrays overlap, which it gives up on.
+static void SlerpKernel(const float* __restrict aW, const float* __restrict aX, const float* __restrict aY, const float* __restrict aZ,
+	const float* __restrict bW, const float* __restrict bX, const float* __restrict bY, const float* __restrict bZ,
+	const float* __restrict t,
+	float* __restrict outW, float* __restrict outX, float* __restrict outY, float* __restrict outZ, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		float aw = aW[i], ax = aX[i], ay = aY[i], az = aZ[i];
+		float bw = bW[i], bx = bX[i], by = bY[i], bz = bZ[i];
+
+		float cosHalfTheta = (aw * bw) + (ax * bx) + (ay * by) + (az * bz);
+		bool same = fabsf(cosHalfTheta) >= 1.0f;
+
+		// Where |cosHalfTheta| >= 1 these are NaN or infinite, but those lanes are replaced by the `same' case below
+		float halfTheta = BatchAcos(cosHalfTheta);
+		float sinHalfTheta = sqrtf((1.0f - cosHalfTheta) * (1.0f + cosHalfTheta));
+		bool opposite = sinHalfTheta < 0.001f;
+		bool close = opposite & (cosHalfTheta > 0.0f);
+
+		float invSin = 1.0f / sinHalfTheta;
+		float ratioA = BatchSin((1.0f - t[i]) * halfTheta) * invSin;
+		float ratioB = BatchSin(t[i] * halfTheta) * invSin;
+
+		ratioA = opposite ? 0.5f : ratioA;
+		ratioB = opposite ? 0.5f : ratioB;
+		ratioA = close ? 1.0f - t[i] : ratioA;
+		ratioB = close ? t[i] : ratioB;
+		ratioA = same ? 1.0f : ratioA;
+		ratioB = same ? 0.0f : ratioB;
+
+		outW[i] = aw * ratioA + bw * ratioB;
+		outX[i] = ax * ratioA + bx * ratioB;
+		outY[i] = ay * ratioA + by * ratioB;
+		outZ[i] = az * ratioA + bz * ratioB;
+	}
+}
+
+void SlerpBatch(QuaternionSoA a, QuaternionSoA b, const float* t, QuaternionSoA out, int count)
+{
+	SlerpKernel(a.w, a.x, a.y, a.z, b.w, b.x, b.y, b.z, t, out.w, out.x, out.y, out.z, count);
+}
+
+// Like SlerpKernel, the arrays are passed separately and marked __restrict so the loop is vectorized.
+static void AddAlignedKernel(float* __restrict sW, float* __restrict sX, float* __restrict sY, float* __restrict sZ,
+	const float* __restrict qW, const float* __restrict qX, const float* __restrict qY, const float* __restrict qZ,
+	float weight, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		float dot = sW[i] * qW[i] + sX[i] * qX[i] + sY[i] * qY[i] + sZ[i] * qZ[i];
+		float k = (dot < 0.0f) ? -weight : weight;
+
+		sW[i] += k * qW[i];
+		sX[i] += k * qX[i];
+		sY[i] += k * qY[i];
+		sZ[i] += k * qZ[i];
+	}
+}
+
+void AddAlignedBatch(QuaternionSoA sum, QuaternionSoA q, float weight, int count)
+{
+	AddAlignedKernel(sum.w, sum.x, sum.y, sum.z, q.w, q.x, q.y, q.z, weight, count);
+}
+
+// Below this many vectors per thread, starting the threads costs more than it saves
+static const int ROTATE_CHUNK = 65536;
+
+// With a single quaternion, the rotation matrix is built once and then costs 15 flops per vector,
+//  fewer than the 18 of the cross product form. The loop is simple enough to be vectorized as it is,
+//  and reads each vector completely before writing it, so in and out may be the same array.
+static void RotateRange(Quaternion q, const Vector3D* in, Vector3D* out, int count)
+{
+	Matrix3D m = RotationMatrix(q);
+
+	for (int i = 0; i < count; i++)
+	{
+		out[i] = m * in[i];
+	}
+}
+
+// With a quaternion per vector, the cross product form is cheaper than building a matrix for each one.
+// The vectors are rotated in blocks of ROTATE_BLOCK, which are first copied into local arrays of
+//  x, y and z (and w, x, y, z for the quaternions). The rotation is then a loop over separate arrays that
+//  the compiler knows don't overlap, which it vectorizes even for plain SSE2, where the loop over
+//  interleaved Vector3D and Quaternion is not vectorized. It also lets in and out be the same array.
+static const int ROTATE_BLOCK = 64;
+
+static void RotateEachRange(const Quaternion* q, const Vector3D* in, Vector3D* out, int count)
+{
+	float vx[ROTATE_BLOCK], vy[ROTATE_BLOCK], vz[ROTATE_BLOCK];
+	float qw[ROTATE_BLOCK], qx[ROTATE_BLOCK], qy[ROTATE_BLOCK], qz[ROTATE_BLOCK];
+
+	for (int start = 0; start < count; start += ROTATE_BLOCK)
+	{
+		int n = (count - start < ROTATE_BLOCK) ? count - start : ROTATE_BLOCK;
+
+		for (int i = 0; i < n; i++)
+		{
+			vx[i] = in[start + i].x;
+			vy[i] = in[start + i].y;
+			vz[i] = in[start + i].z;
+			qw[i] = q[start + i].w;
+			qx[i] = q[start + i].x;
+			qy[i] = q[start + i].y;
+			qz[i] = q[start + i].z;
+		}
+
+		// The same steps as RotateVector: t = 2(u x v), v' = v + w * t + u x t
+		for (int i = 0; i < n; i++)
+		{
+			float tx = 2.0f * (qy[i] * vz[i] - qz[i] * vy[i]);
+			float ty = 2.0f * (qz[i] * vx[i] - qx[i] * vz[i]);
+			float tz = 2.0f * (qx[i] * vy[i] - qy[i] * vx[i]);
+
+			float rx = vx[i] + qw[i] * tx + (qy[i] * tz - qz[i] * ty);
+			float ry = vy[i] + qw[i] * ty + (qz[i] * tx - qx[i] * tz);
+			float rz = vz[i] + qw[i] * tz + (qx[i] * ty - qy[i] * tx);
+
+			vx[i] = rx;
+			vy[i] = ry;
+			vz[i] = rz;
+		}
+
+		for (int i = 0; i < n; i++)
+		{
+			out[start + i] = Vector3D(vx[i], vy[i], vz[i]);
+		}
+	}
+}
+
+void RotateVectors(Quaternion q, const Vector3D* in, Vector3D* out, int count, int threads)
+{
+	ParallelFor(count, threads, ROTATE_CHUNK, [=](int begin, int end)
+	{
+		RotateRange(q, in + begin, out + begin, end - begin);
+	});
+}
+
+void RotateVectors(const Quaternion* q, const Vector3D* in, Vector3D* out, int count, int threads)
+{
+	ParallelFor(count, threads, ROTATE_CHUNK, [=](int begin, int end)
+	{
+		RotateEachRange(q + begin, in + begin, out + begin, end - begin);
+	});
+}
+
+// The matrices are built in blocks of MATRIX_BLOCK quaternions, the same way as RotateEachRange:
+//  the quaternions are copied into local arrays of w, x, y and z, the nine elements of each rotation are
+//  worked out by a loop over separate arrays, which is vectorized, and then the blocks are written out
+//  in the requested layout. Writing the output is only stores, and there is no Matrix3D to copy out of.
+static const int MATRIX_BLOCK = 64;
+
+// Fills r[k] with element k of each column-major rotation matrix (k = 3 * column + row),
+//  using the same formula as RotationMatrix.
+static void RotationBlock(const Quaternion* q, int n, float r[9][MATRIX_BLOCK])
+{
+	float qw[MATRIX_BLOCK], qx[MATRIX_BLOCK], qy[MATRIX_BLOCK], qz[MATRIX_BLOCK];
+
+	for (int i = 0; i < n; i++)
+	{
+		qw[i] = q[i].w;
+		qx[i] = q[i].x;
+		qy[i] = q[i].y;
+		qz[i] = q[i].z;
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		float w = qw[i], x = qx[i], y = qy[i], z = qz[i];
+
+		r[0][i] = 1 - (2 * y * y) - (2 * z * z);
+		r[1][i] = 2 * ((x * y) + (w * z));
+		r[2][i] = 2 * ((x * z) - (w * y));
+		r[3][i] = 2 * ((x * y) - (w * z));
+		r[4][i] = 1 - (2 * x * x) - (2 * z * z);
+		r[5][i] = 2 * ((y * z) + (w * x));
+		r[6][i] = 2 * ((x * z) + (w * y));
+		r[7][i] = 2 * ((y * z) - (w * x));
+		r[8][i] = 1 - (2 * x * x) - (2 * y * y);
+	}
+}
+
+void RotationMatrices3x3(const Quaternion* q, float* out, int count)
+{
+	float r[9][MATRIX_BLOCK];
+
+	for (int start = 0; start < count; start += MATRIX_BLOCK)
+	{
+		int n = (count - start < MATRIX_BLOCK) ? count - start : MATRIX_BLOCK;
+		RotationBlock(q + start, n, r);
+
+		for (int i = 0; i < n; i++)
+		{
+			float* m = out + 9 * (start + i);
+			for (int k = 0; k < 9; k++)
+			{
+				m[k] = r[k][i];
+			}
+		}
+	}
+}
+
+void TransformMatrices3x4(const Quaternion* q, const Vector3D* t, float* out, int count)
+{
+	float r[9][MATRIX_BLOCK];
+
+	for (int start = 0; start < count; start += MATRIX_BLOCK)
+	{
+		int n = (count - start < MATRIX_BLOCK) ? count - start : MATRIX_BLOCK;
+		RotationBlock(q + start, n, r);
+
+		for (int i = 0; i < n; i++)
+		{
+			float* m = out + 12 * (start + i);
+			for (int k = 0; k < 9; k++)
+			{
+				m[k] = r[k][i];
+			}
+
+			Vector3D translation = t ? t[start + i] : Vector3D();
+			m[9] = translation.x;
+			m[10] = translation.y;
+			m[11] = translation.z;
+		}
+	}
+}
+
+void TransformMatrices4x4(const Quaternion* q, const Vector3D* t, float* out, int count)
+{
+	float r[9][MATRIX_BLOCK];
+
+	for (int start = 0; start < count; start += MATRIX_BLOCK)
+	{
+		int n = (count - start < MATRIX_BLOCK) ? count - start : MATRIX_BLOCK;
+		RotationBlock(q + start, n, r);
+
+		for (int i = 0; i < n; i++)
+		{
+			float* m = out + 16 * (start + i);
+			m[0] = r[0][i]; m[1] = r[1][i]; m[2] = r[2][i]; m[3] = 0;
+			m[4] = r[3][i]; m[5] = r[4][i]; m[6] = r[5][i]; m[7] = 0;
+			m[8] = r[6][i]; m[9] = r[7][i]; m[10] = r[8][i]; m[11] = 0;
+
+			Vector3D translation = t ? t[start + i] : Vector3D();
+			m[12] = translation.x;
+			m[13] = translation.y;
+			m[14] = translation.z;
+			m[15] = 1;
+		}
+	}
+}
+
+// Works out Rotation(m) for a block of matrices whose element (i, j) is in r[3 * j + i], one lane per matrix.
+// The selects are the same as in Rotation, written out per component so they become vector blends.
+static void ExtractBlock(float r[9][MATRIX_BLOCK], int n, Quaternion* out)
+{
+	float qw[MATRIX_BLOCK], qx[MATRIX_BLOCK], qy[MATRIX_BLOCK], qz[MATRIX_BLOCK];
+
+	for (int i = 0; i < n; i++)
+	{
+		float m00 = r[0][i], m10 = r[1][i], m20 = r[2][i];
+		float m01 = r[3][i], m11 = r[4][i], m21 = r[5][i];
+		float m02 = r[6][i], m12 = r[7][i], m22 = r[8][i];
+
+		float tw = 1 + m00 + m11 + m22;
+		float tx = 1 + m00 - m11 - m22;
+		float ty = 1 - m00 + m11 - m22;
+		float tz = 1 - m00 - m11 + m22;
+
+		float wx = m21 - m12;
+		float wy = m02 - m20;
+		float wz = m10 - m01;
+		float xy = m01 + m10;
+		float xz = m02 + m20;
+		float yz = m12 + m21;
+
+		// & instead of && so that no comparison is skipped, which would be a branch
+		bool useW = (tw >= tx) & (tw >= ty) & (tw >= tz);
+		bool useX = !useW & (tx >= ty) & (tx >= tz);
+		bool useY = !useW & !useX & (ty >= tz);
+
+		float w = useW ? tw : useX ? wx : useY ? wy : wz;
+		float x = useW ? wx : useX ? tx : useY ? xy : xz;
+		float y = useW ? wy : useX ? xy : useY ? ty : yz;
+		float z = useW ? wz : useX ? xz : useY ? yz : tz;
+
+		float s = 1.0f / sqrtf(w * w + x * x + y * y + z * z);
+		s = (w < 0) ? -s : s;
+
+		qw[i] = w * s;
+		qx[i] = x * s;
+		qy[i] = y * s;
+		qz[i] = z * s;
+	}
+
+	for (int i = 0; i < n; i++)
+	{
+		out[i] = Quaternion(qw[i], qx[i], qy[i], qz[i]);
+	}
+}
+
+void RotationsFromMatrices(const Matrix3D* m, Quaternion* out, int count)
+{
+	float r[9][MATRIX_BLOCK];
+
+	for (int start = 0; start < count; start += MATRIX_BLOCK)
+	{
+		int n = (count - start < MATRIX_BLOCK) ? count - start : MATRIX_BLOCK;
+
+		for (int i = 0; i < n; i++)
+		{
+			const Matrix3D& mi = m[start + i];
+			for (int k = 0; k < 9; k++)
+			{
+				r[k][i] = mi(k % 3, k / 3);
+			}
+		}
+
+		ExtractBlock(r, n, out + start);
+	}
+}
+
+void RotationsFromMatrices(const Matrix4D* m, Quaternion* out, int count)
+{
+	float r[9][MATRIX_BLOCK];
+
+	for (int start = 0; start < count; start += MATRIX_BLOCK)
+	{
+		int n = (count - start < MATRIX_BLOCK) ? count - start : MATRIX_BLOCK;
+
+		for (int i = 0; i < n; i++)
+		{
+			const Matrix4D& mi = m[start + i];
+			for (int k = 0; k < 9; k++)
+			{
+				r[k][i] = mi(k % 3, k / 3);
+			}
+		}
+
+		ExtractBlock(r, n, out + start);
+	}
+}
@@ -0,0 +1,81 @@
+/*
+Title: Quaternion Math
+File Name: QuaternionBatch.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "Quaternion.h"
+
+// Many quaternions stored as a structure of arrays (SoA):
+// element i is the quaternion (w[i], x[i], y[i], z[i]).
+// Keeping each component in its own array lets the compiler load 4, 8 or 16 consecutive
+//  components into one SSE, AVX2 or AVX-512 register and process that many quaternions at once.
+struct QuaternionSoA
+{
+	float* w;
+	float* x;
+	float* y;
+	float* z;
+};
+
+// Copies count quaternions between an array of Quaternion and a QuaternionSoA.
+void ToSoA(const Quaternion* q, QuaternionSoA out, int count);
+void FromSoA(QuaternionSoA q, Quaternion* out, int count);
+
+// Slerps count pairs of quaternions: out[i] = Slerp(a[i], b[i], t[i]).
+// Follows the same rules as the scalar Slerp (returns a when |Dot(a, b)| >= 1, lerps when the angle is close to 0,
+//  and returns the midpoint when it is close to 180 degrees), but works in float with polynomial
+//  approximations of acos and sin so the loop has no branches or library calls and is vectorized.
+// t[i] must lie in [0, 1].
+// For unit quaternions with Dot(a, b) >= -0.9 every component is within 6 ULPs of 1.0f (7e-7) of the scalar Slerp,
+//  and both are within 5 ULPs of Slerp in double.
+// As Dot(a, b) approaches -1 the ratios grow like 1 / sin(halfTheta), and so does the difference:
+//  about 2e-6 at -0.99, 2e-5 at -0.9999 and 3e-4 just before the 180 degree cutoff.
+// out must not overlap a, b or t.
+void SlerpBatch(QuaternionSoA a, QuaternionSoA b, const float* t, QuaternionSoA out, int count);
+
+// Adds weight * q[i] to sum[i] for count quaternions, negating q[i] where Dot(sum[i], q[i]) < 0.
+// q and -q are the same rotation, and flipping puts each one on the side of the running sum, so rotations
+//  can be blended or averaged by summing them (starting from zero, so the first is never flipped) and normalizing.
+// sum must not overlap q.
+void AddAlignedBatch(QuaternionSoA sum, QuaternionSoA q, float weight, int count);
+
+// Rotates count vectors: out[i] = RotateVector(in[i], q).
+// q must be a unit quaternion (q[i] for the second version). out may be the same array as in, but must not partially overlap it.
+// The work is split across up to threads threads (0 for one per hardware thread, see ParallelFor),
+//  though arrays under about 64K vectors always run on the calling thread.
+void RotateVectors(Quaternion q, const Vector3D* in, Vector3D* out, int count, int threads = 1);
+
+// Rotates each vector by its own quaternion: out[i] = RotateVector(in[i], q[i]).
+void RotateVectors(const Quaternion* q, const Vector3D* in, Vector3D* out, int count, int threads = 1);
+
+// Converts count quaternions to rotation matrices, the same as RotationMatrix, and writes them
+//  one after another into out as column-major floats.
+// 3x3 writes 9 floats per matrix: the three columns of the rotation, the layout of Matrix3D.
+// 3x4 writes 12 floats per matrix: the three columns, then the translation t[i] as a fourth column.
+// 4x4 writes 16 floats per matrix: the 3x4 columns extended with a bottom row of (0, 0, 0, 1), the layout of Matrix4D.
+// So out can also point at an array of Matrix3D (3x3) or Matrix4D (4x4).
+// t may be nullptr for no translation. out must not overlap q or t.
+void RotationMatrices3x3(const Quaternion* q, float* out, int count);
+void TransformMatrices3x4(const Quaternion* q, const Vector3D* t, float* out, int count);
+void TransformMatrices4x4(const Quaternion* q, const Vector3D* t, float* out, int count);
+
+// Extracts count quaternions from rotation matrices: out[i] = Rotation(m[i]), with the same largest-diagonal
+//  method and the same rules (m[i] must be a rotation, results have w >= 0).
+// For Matrix4D only the upper left 3x3 is used.
+void RotationsFromMatrices(const Matrix3D* m, Quaternion* out, int count);
+void RotationsFromMatrices(const Matrix4D* m, Quaternion* out, int count);
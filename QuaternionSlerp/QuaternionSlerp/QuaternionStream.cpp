@@ -0,0 +1,533 @@
+/*
+Title: Quaternion Math
+File Name: QuaternionStream.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "QuaternionStream.h"
+#include "QuaternionBatch.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// Records are worked out this many at a time
+static const int STREAM_CHUNK = 4096;
+
+// Text is read this many bytes at a time. A line must fit in it.
+static const size_t STREAM_READ = 1 << 20;
+
+// The number of arguments of each operation, indexed by StreamOp
+static const int ARGUMENT_COUNT[4] = { 0, 9, 7, 8 };
+
+// Scratch arrays for one chunk, kept between chunks so nothing is allocated per chunk
+struct StreamChunk
+{
+	float aw[STREAM_CHUNK], ax[STREAM_CHUNK], ay[STREAM_CHUNK], az[STREAM_CHUNK];
+	float bw[STREAM_CHUNK], bx[STREAM_CHUNK], by[STREAM_CHUNK], bz[STREAM_CHUNK];
+	float ow[STREAM_CHUNK], ox[STREAM_CHUNK], oy[STREAM_CHUNK], oz[STREAM_CHUNK];
+	float t[STREAM_CHUNK];
+	Quaternion q[STREAM_CHUNK];
+	Vector3D v[STREAM_CHUNK];
+	int index[STREAM_CHUNK];
+};
+
+// Works out n records (at most STREAM_CHUNK). The slerps and rotations are each gathered into their own arrays,
+//  run through SlerpBatch and RotateVectors, and scattered back to the results in the order of the records.
+static void ProcessChunk(const StreamRecord* records, StreamResult* results, int n, StreamChunk& c)
+{
+	int slerps = 0;
+	for (int i = 0; i < n; i++)
+	{
+		const float* a = records[i].args;
+
+		// SlerpBatch needs t in [0, 1], and Slerp extrapolates outside it
+		if (records[i].op == StreamOp::Slerp && a[8] >= 0.0f && a[8] <= 1.0f)
+		{
+			c.aw[slerps] = a[0]; c.ax[slerps] = a[1]; c.ay[slerps] = a[2]; c.az[slerps] = a[3];
+			c.bw[slerps] = a[4]; c.bx[slerps] = a[5]; c.by[slerps] = a[6]; c.bz[slerps] = a[7];
+			c.t[slerps] = a[8];
+			c.index[slerps++] = i;
+		}
+		else if (records[i].op == StreamOp::Slerp)
+		{
+			Quaternion q = Slerp(Quaternion(a[0], a[1], a[2], a[3]), Quaternion(a[4], a[5], a[6], a[7]), a[8]);
+			results[i] = StreamResult{ { q.w, q.x, q.y, q.z } };
+		}
+		else if (records[i].op == StreamOp::Mul)
+		{
+			Quaternion q = Quaternion(a[0], a[1], a[2], a[3]) * Quaternion(a[4], a[5], a[6], a[7]);
+			results[i] = StreamResult{ { q.w, q.x, q.y, q.z } };
+		}
+	}
+
+	QuaternionSoA qa = { c.aw, c.ax, c.ay, c.az };
+	QuaternionSoA qb = { c.bw, c.bx, c.by, c.bz };
+	QuaternionSoA qo = { c.ow, c.ox, c.oy, c.oz };
+	SlerpBatch(qa, qb, c.t, qo, slerps);
+	for (int k = 0; k < slerps; k++)
+	{
+		results[c.index[k]] = StreamResult{ { c.ow[k], c.ox[k], c.oy[k], c.oz[k] } };
+	}
+
+	int rotations = 0;
+	for (int i = 0; i < n; i++)
+	{
+		if (records[i].op == StreamOp::Rotate)
+		{
+			const float* a = records[i].args;
+			c.q[rotations] = Quaternion(a[0], a[1], a[2], a[3]);
+			c.v[rotations] = Vector3D(a[4], a[5], a[6]);
+			c.index[rotations++] = i;
+		}
+	}
+
+	RotateVectors(c.q, c.v, c.v, rotations);
+	for (int k = 0; k < rotations; k++)
+	{
+		results[c.index[k]] = StreamResult{ { c.v[k].x, c.v[k].y, c.v[k].z, 0.0f } };
+	}
+}
+
+// Powers of ten from 1e-64 to 1e64, for reading and writing numbers
+static const int POWER_OFFSET = 64;
+
+struct PowerTable
+{
+	double powers[2 * POWER_OFFSET + 1];
+
+	PowerTable()
+	{
+		for (int i = 0; i <= 2 * POWER_OFFSET; i++)
+		{
+			powers[i] = std::pow(10.0, i - POWER_OFFSET);
+		}
+	}
+};
+
+static const double* PowersOfTen()
+{
+	static const PowerTable table;
+	return table.powers;
+}
+
+// The powers of ten that a float holds exactly, for the fast path of ParseFloat
+static const float FLOAT_POWERS_OF_TEN[11] = { 1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f };
+
+// Reads a number from p, which must be followed by a space, tab, \r, \n or the end of the text.
+// Decimal numbers whose digits fit in a float exactly (below 2^24) with an exponent within 10^10 of them are read
+//  with one multiplication or division in float. Both operands are exact, so the one rounding gives the float
+//  nearest to the text (Clinger's fast path). Anything else (longer numbers, inf, nan, hex) is handed to strtof,
+//  because going through double would round twice and can land one float away from the nearest.
+// Returns the character after the number, or nullptr if there isn't one.
+static const char* ParseFloat(const char* p, const char* end, float& value)
+{
+	const char* start = p;
+	bool negative = (p < end && *p == '-');
+	p += (p < end && (*p == '-' || *p == '+')) ? 1 : 0;
+
+	uint64_t mantissa = 0;
+	int digits = 0, exponent = 0;
+	bool any = false;
+
+	for (; p < end && *p >= '0' && *p <= '9'; p++, any = true)
+	{
+		if (digits < 19)
+		{
+			mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+			digits += (mantissa != 0);
+		}
+		else
+		{
+			exponent++;
+		}
+	}
+	if (p < end && *p == '.')
+	{
+		for (p++; p < end && *p >= '0' && *p <= '9'; p++, any = true)
+		{
+			if (digits < 19)
+			{
+				mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+				digits += (mantissa != 0);
+				exponent--;
+			}
+		}
+	}
+	if (any && p < end && (*p == 'e' || *p == 'E'))
+	{
+		const char* e = p + 1;
+		bool negativeExponent = (e < end && *e == '-');
+		e += (e < end && (*e == '-' || *e == '+')) ? 1 : 0;
+
+		int written = 0;
+		bool exponentDigits = false;
+		for (; e < end && *e >= '0' && *e <= '9'; e++, exponentDigits = true)
+		{
+			written = (written < 10000) ? written * 10 + (*e - '0') : written;
+		}
+		if (exponentDigits)
+		{
+			exponent += negativeExponent ? -written : written;
+			p = e;
+		}
+	}
+
+	bool separated = (p == end || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n');
+	if (any && separated && mantissa < (1ull << 24) && exponent >= -10 && exponent <= 10)
+	{
+		float f = (float)mantissa;
+		f = (exponent < 0) ? f / FLOAT_POWERS_OF_TEN[-exponent] : f * FLOAT_POWERS_OF_TEN[exponent];
+		value = negative ? -f : f;
+		return p;
+	}
+
+	// The slow path needs the number on its own with a terminating 0
+	const char* tokenEnd = start;
+	while (tokenEnd < end && *tokenEnd != ' ' && *tokenEnd != '\t' && *tokenEnd != '\r' && *tokenEnd != '\n')
+	{
+		tokenEnd++;
+	}
+
+	char token[64];
+	size_t length = (size_t)(tokenEnd - start);
+	if (length == 0 || length >= sizeof(token))
+	{
+		return nullptr;
+	}
+
+	memcpy(token, start, length);
+	token[length] = 0;
+
+	char* parsedEnd;
+	float f = strtof(token, &parsedEnd);
+	if (parsedEnd != token + length)
+	{
+		return nullptr;
+	}
+
+	value = f;
+	return tokenEnd;
+}
+
+// Writes value with 9 significant digits, dropping trailing zeros, in plain notation for magnitudes from 1e-5 up to 1e9
+//  and as d.ddde+X outside that. The digits come from one multiplication in double, which is accurate to far more
+//  than the 9 digits that a float needs to be read back exactly.
+// Returns the end of what was written, which is at most 16 characters.
+static char* FormatFloat(float value, char* out)
+{
+	if (value != value)
+	{
+		memcpy(out, "nan", 3);
+		return out + 3;
+	}
+	if (value < 0)
+	{
+		*out++ = '-';
+		value = -value;
+	}
+	if (value == 0)
+	{
+		*out++ = '0';
+		return out;
+	}
+	if (std::isinf(value))
+	{
+		memcpy(out, "inf", 3);
+		return out + 3;
+	}
+
+	const double* powers = PowersOfTen();
+	double d = value;
+
+	// The decimal exponent is within one of the binary exponent times log10(2)
+	int binaryExponent;
+	std::frexp(d, &binaryExponent);
+	int exponent = (int)std::floor((binaryExponent - 1) * 0.30102999566398120);
+	exponent += (d >= powers[POWER_OFFSET + exponent + 1]) ? 1 : 0;
+
+	uint64_t digits = (uint64_t)std::llround(d * powers[POWER_OFFSET + 8 - exponent]);
+	if (digits >= 1000000000)
+	{
+		digits /= 10;
+		exponent++;
+	}
+
+	char text[9];
+	for (int i = 8; i >= 0; i--)
+	{
+		text[i] = (char)('0' + digits % 10);
+		digits /= 10;
+	}
+
+	int significant = 9;
+	while (significant > 1 && text[significant - 1] == '0')
+	{
+		significant--;
+	}
+
+	if (exponent >= -5 && exponent < 9)
+	{
+		if (exponent < 0)
+		{
+			*out++ = '0';
+			*out++ = '.';
+			for (int i = -1; i > exponent; i--)
+			{
+				*out++ = '0';
+			}
+			memcpy(out, text, significant);
+			return out + significant;
+		}
+
+		int whole = exponent + 1;
+		for (int i = 0; i < whole; i++)
+		{
+			*out++ = (i < significant) ? text[i] : '0';
+		}
+		if (significant > whole)
+		{
+			*out++ = '.';
+			memcpy(out, text + whole, significant - whole);
+			out += significant - whole;
+		}
+		return out;
+	}
+
+	*out++ = text[0];
+	if (significant > 1)
+	{
+		*out++ = '.';
+		memcpy(out, text + 1, significant - 1);
+		out += significant - 1;
+	}
+	return out + sprintf(out, "e%+d", exponent);
+}
+
+// Reads the record on the line [p, end), which has no \n. Returns 1 for a record, 0 for a line to skip, -1 for an error.
+static int ParseLine(const char* p, const char* end, StreamRecord& record)
+{
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+	{
+		p++;
+	}
+	if (p == end || *p == '#')
+	{
+		return 0;
+	}
+
+	const char* word = p;
+	while (p < end && *p != ' ' && *p != '\t')
+	{
+		p++;
+	}
+
+	size_t length = (size_t)(p - word);
+	if (length == 5 && memcmp(word, "slerp", 5) == 0)
+	{
+		record.op = StreamOp::Slerp;
+	}
+	else if (length == 6 && memcmp(word, "rotate", 6) == 0)
+	{
+		record.op = StreamOp::Rotate;
+	}
+	else if (length == 3 && memcmp(word, "mul", 3) == 0)
+	{
+		record.op = StreamOp::Mul;
+	}
+	else
+	{
+		return -1;
+	}
+
+	int count = ARGUMENT_COUNT[(int)record.op];
+	for (int i = 0; i < 9; i++)
+	{
+		record.args[i] = 0.0f;
+	}
+	for (int i = 0; i < count; i++)
+	{
+		while (p < end && (*p == ' ' || *p == '\t'))
+		{
+			p++;
+		}
+		p = ParseFloat(p, end, record.args[i]);
+		if (p == nullptr)
+		{
+			return -1;
+		}
+	}
+
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+	{
+		p++;
+	}
+	return (p == end) ? 1 : -1;
+}
+
+// Writes the results of n records as text
+static bool WriteText(const StreamRecord* records, const StreamResult* results, int n, std::vector<char>& text, std::FILE* out)
+{
+	// A chunk with only blank lines and comments has nothing to write, and text may not have been allocated yet
+	if (n == 0)
+	{
+		return true;
+	}
+
+	// 4 numbers of at most 16 characters, 3 spaces and a newline
+	text.resize((size_t)n * 68);
+	char* p = text.data();
+
+	for (int i = 0; i < n; i++)
+	{
+		int values = (records[i].op == StreamOp::Rotate) ? 3 : 4;
+		for (int k = 0; k < values; k++)
+		{
+			p = FormatFloat(results[i].v[k], p);
+			*p++ = (k + 1 < values) ? ' ' : '\n';
+		}
+	}
+
+	size_t size = (size_t)(p - text.data());
+	return fwrite(text.data(), 1, size, out) == size;
+}
+
+static bool ProcessText(std::FILE* in, std::FILE* out)
+{
+	std::vector<char> buffer(STREAM_READ);
+	std::vector<char> text;
+	std::vector<StreamRecord> records(STREAM_CHUNK);
+	std::vector<StreamResult> results(STREAM_CHUNK);
+	std::vector<StreamChunk> chunk(1);
+	size_t filled = 0;
+	long long line = 0;
+	bool atEnd = false;
+
+	while (!atEnd)
+	{
+		filled += fread(buffer.data() + filled, 1, buffer.size() - filled, in);
+		atEnd = (filled < buffer.size());
+
+		// Only complete lines are read, unless this is the end of the input
+		const char* begin = buffer.data();
+		const char* end = begin + filled;
+		const char* last = end;
+		if (!atEnd)
+		{
+			while (last > begin && last[-1] != '\n')
+			{
+				last--;
+			}
+			if (last == begin)
+			{
+				fprintf(stderr, "line %lld: longer than %d bytes\n", line + 1, (int)STREAM_READ);
+				return false;
+			}
+		}
+
+		const char* p = begin;
+		int n = 0;
+		while (p < last)
+		{
+			const char* newline = (const char*)memchr(p, '\n', (size_t)(last - p));
+			const char* lineEnd = (newline != nullptr) ? newline : last;
+			line++;
+
+			int parsed = ParseLine(p, lineEnd, records[n]);
+			if (parsed < 0)
+			{
+				ProcessChunk(records.data(), results.data(), n, chunk[0]);
+				WriteText(records.data(), results.data(), n, text, out);
+				fprintf(stderr, "line %lld: expected slerp (9 numbers), rotate (7) or mul (8)\n", line);
+				return false;
+			}
+
+			n += parsed;
+			if (n == STREAM_CHUNK)
+			{
+				ProcessChunk(records.data(), results.data(), n, chunk[0]);
+				if (!WriteText(records.data(), results.data(), n, text, out))
+				{
+					return false;
+				}
+				n = 0;
+			}
+
+			p = lineEnd + 1;
+		}
+
+		ProcessChunk(records.data(), results.data(), n, chunk[0]);
+		if (!WriteText(records.data(), results.data(), n, text, out))
+		{
+			return false;
+		}
+
+		// Moves the incomplete last line to the front of the buffer
+		filled = (size_t)(end - last);
+		memmove(buffer.data(), last, filled);
+	}
+
+	return true;
+}
+
+static bool ProcessBinary(std::FILE* in, std::FILE* out)
+{
+	std::vector<StreamRecord> records(STREAM_CHUNK);
+	std::vector<StreamResult> results(STREAM_CHUNK);
+	std::vector<StreamChunk> chunk(1);
+	long long read = 0;
+
+	for (;;)
+	{
+		size_t bytes = fread(records.data(), 1, STREAM_CHUNK * sizeof(StreamRecord), in);
+		int n = (int)(bytes / sizeof(StreamRecord));
+
+		for (int i = 0; i < n; i++)
+		{
+			uint32_t op = (uint32_t)records[i].op;
+			if (op < (uint32_t)StreamOp::Slerp || op > (uint32_t)StreamOp::Mul)
+			{
+				fprintf(stderr, "record %lld: unknown operation %u\n", read + i, op);
+				ProcessChunk(records.data(), results.data(), i, chunk[0]);
+				fwrite(results.data(), sizeof(StreamResult), i, out);
+				return false;
+			}
+		}
+
+		ProcessChunk(records.data(), results.data(), n, chunk[0]);
+		if (fwrite(results.data(), sizeof(StreamResult), n, out) != (size_t)n)
+		{
+			return false;
+		}
+		read += n;
+
+		if (bytes % sizeof(StreamRecord) != 0)
+		{
+			fprintf(stderr, "record %lld: the input ends part way through it\n", read);
+			return false;
+		}
+		if (bytes < STREAM_CHUNK * sizeof(StreamRecord))
+		{
+			return true;
+		}
+	}
+}
+
+bool ProcessStream(std::FILE* in, std::FILE* out, StreamFormat format)
+{
+	bool processed = (format == StreamFormat::Binary) ? ProcessBinary(in, out) : ProcessText(in, out);
+	return (fflush(out) == 0) && processed;
+}
@@ -0,0 +1,63 @@
+/*
+Title: Quaternion Math
+File Name: QuaternionStream.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "Quaternion.h"
+
+#include <cstdint>
+#include <cstdio>
+
+// Processes a stream of quaternion operations, so that the program can be used as a batch tool:
+//  QuaternionSlerp stream [--binary] [input [output]]
+// reads records from input (or standard input) and writes one result per record to output (or standard output).
+// Records are read in chunks, and each chunk is worked out with the batch functions (SlerpBatch, RotateVectors).
+// This is meant for batch jobs, not for talking to the program a record at a time: the input is read in blocks
+//  (1 MB of text, or 4096 binary records) which only end early at the end of the input, so a program writing
+//  to a pipe into it sees no results until it has written a whole block or closed the pipe.
+//
+// The text form has one record per line, with numbers separated by spaces or tabs:
+//  slerp aw ax ay az bw bx by bz t		writes Slerp(a, b, t) as "w x y z"
+//  rotate qw qx qy qz vx vy vz			writes RotateVector(v, q) as "x y z" (q must be a unit quaternion)
+//  mul qw qx qy qz rw rx ry rz			writes q * r as "w x y z"
+// Empty lines and lines starting with # are skipped and write nothing.
+// Results are written with 9 significant digits, which is enough to read back exactly the same float.
+//
+// The binary form is a sequence of StreamRecords, and writes a StreamResult for each one,
+//  in the byte order of the machine, with no header. A rotate result has 0 in its fourth float.
+
+enum class StreamFormat { Text, Binary };
+
+enum class StreamOp : uint32_t { Slerp = 1, Rotate = 2, Mul = 3 };
+
+// One operation: op, then its arguments in the order of the text form, with the unused ones 0
+struct StreamRecord
+{
+	StreamOp op;
+	float args[9];
+};
+
+struct StreamResult
+{
+	float v[4];
+};
+
+// Processes every record in in, writing the results to out.
+// Stops at the first record that can't be read, with a message on stderr, and returns false;
+//  the results of the records before it have been written. Also returns false if out can't be written.
+bool ProcessStream(std::FILE* in, std::FILE* out, StreamFormat format);
@@ -0,0 +1,89 @@
+/*
+Title: Quaternion Math
+File Name: RotationTables.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "RotationTables.h"
+#include "Matrix3D.h"
+
+// RotationTables.h is all constexpr, so nothing in it is compiled unless something uses it.
+// The checks below evaluate the tables at compile time, so a mistake in them stops the build.
+
+static constexpr bool Near(float a, float b, float tolerance) noexcept
+{
+	return (a - b <= tolerance) && (b - a <= tolerance);
+}
+
+// Each rotation must be a unit quaternion, and no two may be the same rotation (q and -q count as the same).
+template <int N>
+static constexpr bool UnitAndDistinct(const QuaternionTable<N>& table) noexcept
+{
+	for (int i = 0; i < N; i++)
+	{
+		if (!Near(Norm(table[i]), 1.0f, 1e-5f))
+		{
+			return false;
+		}
+		for (int j = 0; j < i; j++)
+		{
+			float d = Dot(table[i], table[j]);
+			if (d > 0.999f || d < -0.999f)
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// A rotation maps the cube onto itself when its matrix only holds -1, 0 and 1.
+// The cube rotations also promise w >= 0.
+static constexpr bool MapsCubeOntoItself(const QuaternionTable<24>& table) noexcept
+{
+	for (int k = 0; k < 24; k++)
+	{
+		if (table[k].w < 0)
+		{
+			return false;
+		}
+
+
+		Matrix3D m = RotationMatrix(table[k]);
+		for (int i = 0; i < 3; i++)
+		{
+			for (int j = 0; j < 3; j++)
+			{
+				if (!Near(m(i, j), 0, 1e-5f) && !Near(m(i, j), 1, 1e-5f) && !Near(m(i, j), -1, 1e-5f))
+				{
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+static_assert(CubeRotations[0].w == 1 && CubeRotations[0].x == 0 && CubeRotations[0].y == 0 && CubeRotations[0].z == 0,
+	"the first cube rotation must be the identity");
+static_assert(UnitAndDistinct(CubeRotations), "the cube rotations must be 24 different unit quaternions");
+static_assert(MapsCubeOntoItself(CubeRotations), "every cube rotation must have w >= 0 and map the cube onto itself");
+
+// A quarter turn about z is (cos 45, 0, 0, sin 45)
+static constexpr QuaternionTable<4> QUARTER_TURNS = MakeAxisRotations<4>(Vector3D(0, 0, 1));
+static_assert(UnitAndDistinct(QUARTER_TURNS), "the axis rotations must be different unit quaternions");
+static_assert(Near(QUARTER_TURNS[0].w, 1, 1e-6f) && Near(QUARTER_TURNS[1].w, 0.70710678f, 1e-6f)
+	&& Near(QUARTER_TURNS[1].z, 0.70710678f, 1e-6f) && Near(QUARTER_TURNS[1].x, 0, 1e-6f) && Near(QUARTER_TURNS[2].z, 1, 1e-6f),
+	"MakeAxisRotations must step evenly about the axis from the identity");
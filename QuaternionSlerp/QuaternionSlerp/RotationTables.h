@@ -0,0 +1,103 @@
+/*
+Title: Quaternion Math
+File Name: RotationTables.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "Quaternion.h"
+
+// Tables of rotations built at compile time, so they sit in read-only data and cost nothing at startup.
+// Since the tables are constexpr, a lookup with a constant index is folded into the code that uses it.
+
+// A fixed number of rotations. C++14 functions can't return plain arrays, so they return this instead.
+template <int N>
+struct QuaternionTable
+{
+	Quaternion q[N];
+
+	constexpr const Quaternion& operator[](int i) const noexcept
+	{
+		return q[i];
+	}
+
+	constexpr int size() const noexcept
+	{
+		return N;
+	}
+};
+
+// Returns the 24 rotations that map a cube centered on the origin onto itself.
+// The first one is the identity, and every quaternion has w >= 0.
+constexpr QuaternionTable<24> MakeCubeRotations() noexcept;
+
+// Returns N rotations about axis, evenly spaced over a full turn and starting at the identity.
+template <int N>
+constexpr QuaternionTable<N> MakeAxisRotations(Vector3D axis) noexcept;
+
+// The cube rotations are all the products of quarter turns about x and y.
+// Starting from the identity, we multiply every rotation found so far by both quarter turns
+//  and add each product that isn't already in the table, until no new ones turn up.
+// q and -q are the same rotation, so two entries match when |Dot| is close to 1.
+constexpr QuaternionTable<24> MakeCubeRotations() noexcept
+{
+	const float halfPi = 1.57079632679489662f;
+	const Quaternion turns[2] = { ConstexprRotation(Vector3D(1, 0, 0), halfPi), ConstexprRotation(Vector3D(0, 1, 0), halfPi) };
+
+	QuaternionTable<24> table{};
+	table.q[0] = Quaternion(1, 0, 0, 0);
+	int count = 1;
+
+	for (int i = 0; i < count; i++)
+	{
+		for (int j = 0; j < 2; j++)
+		{
+			Quaternion r = turns[j] * table.q[i];
+			r = (r.w < 0) ? -r : r;
+
+			bool found = false;
+			for (int k = 0; k < count; k++)
+			{
+				float d = Dot(r, table.q[k]);
+				found = found || (d > 0.999f) || (d < -0.999f);
+			}
+
+			if (!found && count < 24)
+			{
+				table.q[count++] = r;
+			}
+		}
+	}
+
+	return table;
+}
+
+template <int N>
+constexpr QuaternionTable<N> MakeAxisRotations(Vector3D axis) noexcept
+{
+	const double twoPi = 6.28318530717958648;
+
+	QuaternionTable<N> table{};
+	for (int i = 0; i < N; i++)
+	{
+		table.q[i] = ConstexprRotation(axis, (float)(twoPi * i / N));
+	}
+
+	return table;
+}
+
+// Every 90 degree turn about the x, y and z axes and their combinations
+constexpr QuaternionTable<24> CubeRotations = MakeCubeRotations();
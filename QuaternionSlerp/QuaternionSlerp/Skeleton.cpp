@@ -0,0 +1,178 @@
+/*
+Title: Quaternion Math
+File Name: Skeleton.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Skeleton.h"
+#include "Parallel.h"
+
+// Joints are composed in blocks of this many, copied into local arrays one component each,
+//  the same way as the kernels in QuaternionBatch.cpp.
+static const int JOINT_BLOCK = 64;
+
+// Below this many characters per thread, starting the threads costs more than it saves
+static const int CHARACTER_CHUNK = 16;
+
+// Builds the skeleton one depth at a time: the roots, then the children of the joints
+//  added at the previous depth, until a depth adds no joints.
+Skeleton MakeSkeleton(const int* parents, int count, int* order)
+{
+	std::vector<std::vector<int>> children(count);
+	std::vector<int> sorted;
+	sorted.reserve(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		if (parents[i] < 0 || parents[i] >= count)
+		{
+			sorted.push_back(i);
+		}
+		else
+		{
+			children[parents[i]].push_back(i);
+		}
+	}
+
+	// Where each original joint ended up in the skeleton
+	std::vector<int> index(count, -1);
+	Skeleton skeleton;
+	skeleton.levels.push_back(0);
+
+	int begin = 0;
+	while (begin < (int)sorted.size())
+	{
+		int end = (int)sorted.size();
+		skeleton.levels.push_back(end);
+
+		for (int i = begin; i < end; i++)
+		{
+			index[sorted[i]] = i;
+			for (int child : children[sorted[i]])
+			{
+				sorted.push_back(child);
+			}
+		}
+
+		begin = end;
+	}
+
+	skeleton.parents.resize(sorted.size());
+	for (int i = 0; i < (int)sorted.size(); i++)
+	{
+		int parent = parents[sorted[i]];
+		skeleton.parents[i] = (parent < 0 || parent >= count) ? -1 : index[parent];
+
+		if (order != nullptr)
+		{
+			order[i] = sorted[i];
+		}
+	}
+
+	return skeleton;
+}
+
+// Composes n joints whose parents' world transforms are already known: the same steps as Compose, one lane per joint.
+// p holds the parents' world transforms and l the local transforms, as rotation w, x, y, z, translation x, y, z and scale;
+//  the world transforms are written over l.
+static void ComposeBlock(float p[8][JOINT_BLOCK], float l[8][JOINT_BLOCK], int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		float pw = p[0][i], px = p[1][i], py = p[2][i], pz = p[3][i];
+		float lw = l[0][i], lx = l[1][i], ly = l[2][i], lz = l[3][i];
+
+		// The parent's scale and rotation applied to the local translation, as in RotateVector:
+		//  t = 2(u x v), v' = v + w * t + u x t
+		float vx = p[7][i] * l[4][i], vy = p[7][i] * l[5][i], vz = p[7][i] * l[6][i];
+		float tx = 2.0f * (py * vz - pz * vy);
+		float ty = 2.0f * (pz * vx - px * vz);
+		float tz = 2.0f * (px * vy - py * vx);
+
+		l[4][i] = p[4][i] + vx + pw * tx + (py * tz - pz * ty);
+		l[5][i] = p[5][i] + vy + pw * ty + (pz * tx - px * tz);
+		l[6][i] = p[6][i] + vz + pw * tz + (px * ty - py * tx);
+		l[7][i] = p[7][i] * l[7][i];
+
+		// The rotations, as in operator*
+		l[0][i] = pw * lw - px * lx - py * ly - pz * lz;
+		l[1][i] = pw * lx + px * lw + py * lz - pz * ly;
+		l[2][i] = pw * ly + py * lw + pz * lx - px * lz;
+		l[3][i] = pw * lz + pz * lw + px * ly - py * lx;
+	}
+}
+
+static void ToBlock(const JointTransform& j, float b[8][JOINT_BLOCK], int i)
+{
+	b[0][i] = j.rotation.w;
+	b[1][i] = j.rotation.x;
+	b[2][i] = j.rotation.y;
+	b[3][i] = j.rotation.z;
+	b[4][i] = j.translation.x;
+	b[5][i] = j.translation.y;
+	b[6][i] = j.translation.z;
+	b[7][i] = j.scale;
+}
+
+void ComputeWorldTransforms(const Skeleton& skeleton, const JointTransform* local, JointTransform* world)
+{
+	float p[8][JOINT_BLOCK], l[8][JOINT_BLOCK];
+	const int* parents = skeleton.parents.data();
+	int levelCount = (int)skeleton.levels.size() - 1;
+
+	// The roots have nothing to compose with
+	int roots = (levelCount > 0) ? skeleton.levels[1] : 0;
+	for (int i = 0; i < roots; i++)
+	{
+		world[i] = local[i];
+	}
+
+	for (int d = 1; d < levelCount; d++)
+	{
+		int end = skeleton.levels[d + 1];
+
+		for (int start = skeleton.levels[d]; start < end; start += JOINT_BLOCK)
+		{
+			int n = (end - start < JOINT_BLOCK) ? end - start : JOINT_BLOCK;
+
+			for (int i = 0; i < n; i++)
+			{
+				ToBlock(world[parents[start + i]], p, i);
+				ToBlock(local[start + i], l, i);
+			}
+
+			ComposeBlock(p, l, n);
+
+			for (int i = 0; i < n; i++)
+			{
+				world[start + i] = JointTransform(Quaternion(l[0][i], l[1][i], l[2][i], l[3][i]),
+					Vector3D(l[4][i], l[5][i], l[6][i]), l[7][i]);
+			}
+		}
+	}
+}
+
+void ComputeWorldTransforms(const Skeleton& skeleton, const JointTransform* local, JointTransform* world, int count, int threads)
+{
+	int jointCount = (int)skeleton.parents.size();
+
+	ParallelFor(count, threads, CHARACTER_CHUNK, [&skeleton, local, world, jointCount](int begin, int end)
+	{
+		for (int c = begin; c < end; c++)
+		{
+			ComputeWorldTransforms(skeleton, local + c * jointCount, world + c * jointCount);
+		}
+	});
+}
@@ -0,0 +1,87 @@
+/*
+Title: Quaternion Math
+File Name: Skeleton.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "Quaternion.h"
+
+#include <vector>
+
+// The transform of a joint relative to its parent: scale by scale, then rotate by rotation, then move by translation.
+// rotation must be a unit quaternion. The scale is uniform, so that composing two transforms gives another one of this form.
+struct JointTransform
+{
+	Quaternion rotation;
+	Vector3D translation;
+	float scale;
+
+	constexpr JointTransform() noexcept
+		: rotation(1, 0, 0, 0), translation(0, 0, 0), scale(1)
+	{
+	}
+
+	constexpr JointTransform(Quaternion r, Vector3D t, float s = 1) noexcept
+		: rotation(r), translation(t), scale(s)
+	{
+	}
+};
+
+// Applies the transform to a point.
+constexpr Vector3D TransformPoint(const JointTransform& j, Vector3D p) noexcept
+{
+	return RotateVector(j.scale * p, j.rotation) + j.translation;
+}
+
+// Returns the transform that applies local and then parent, which takes a joint's local transform to its world transform:
+//  TransformPoint(Compose(parent, local), p) == TransformPoint(parent, TransformPoint(local, p)).
+constexpr JointTransform Compose(const JointTransform& parent, const JointTransform& local) noexcept
+{
+	return JointTransform(parent.rotation * local.rotation,
+		TransformPoint(parent, local.translation),
+		parent.scale * local.scale);
+}
+
+// A hierarchy of joints, stored as parent indices.
+// The joints are ordered by depth: the roots first, then their children, then their grandchildren, and so on.
+// So every parent comes before its children, and the joints at the same depth are next to each other,
+//  which lets all of them be worked on at once since none depends on another.
+struct Skeleton
+{
+	// parents[i] is the parent of joint i, which is less than i, or -1 if joint i is a root
+	std::vector<int> parents;
+	// The joints at depth d are levels[d] up to, but not including, levels[d + 1]
+	std::vector<int> levels;
+};
+
+// Builds a skeleton from parent indices in any order: parents[i] is the parent of joint i, or -1 for a root.
+// The parents must form a tree or forest, with no cycles. Joints that can't be reached from a root are left out.
+// Writes the joint of the original array that each joint of the skeleton came from to order (if it isn't nullptr),
+//  so order[i] is where to find the local transform of skeleton joint i. order must have room for count joints.
+Skeleton MakeSkeleton(const int* parents, int count, int* order = nullptr);
+
+// Forward kinematics: computes the world transform of every joint from the local transforms,
+//  world[i] = Compose(world[parents[i]], local[i]), or local[i] for a root.
+// Both arrays are in skeleton order, with one entry per joint. world may be the same array as local.
+// Each level of the skeleton is done in one pass, in blocks of joints which are vectorized,
+//  reading the arrays straight through from start to end.
+void ComputeWorldTransforms(const Skeleton& skeleton, const JointTransform* local, JointTransform* world);
+
+// Forward kinematics for count characters sharing the same skeleton.
+// The local and world transforms of character c start at index c * jointCount of each array.
+// The characters are split across up to threads threads (0 for one per hardware thread, see ParallelFor).
+void ComputeWorldTransforms(const Skeleton& skeleton, const JointTransform* local, JointTransform* world, int count, int threads = 1);
@@ -0,0 +1,171 @@
+/*
+Title: Quaternion Math
+File Name: Skinning.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Skinning.h"
+#include "Parallel.h"
+
+// The vertices are done in blocks of SKIN_BLOCK.
+// First the 4 bones of each vertex are gathered into local arrays, one per component of each bone slot,
+//  which can't be vectorized since each vertex reads different bones. Then the blending and transforming
+//  is a loop over those arrays with no branches, which the compiler vectorizes across vertices.
+static const int SKIN_BLOCK = 64;
+
+// Below this many vertices per thread, starting the threads costs more than it saves
+static const int SKIN_CHUNK = 16384;
+
+// The bones of each vertex, one array per component of each of the 4 slots (real w, x, y, z, then dual w, x, y, z),
+//  the weights, the vertex itself, and the blended transform, which is worked out into rotation (r) and translation (t).
+struct SkinBlock
+{
+	float b[4][8][SKIN_BLOCK];
+	float w[4][SKIN_BLOCK];
+	float p[3][SKIN_BLOCK];
+	float n[3][SKIN_BLOCK];
+	float r[4][SKIN_BLOCK];
+	float scale[SKIN_BLOCK];
+	float t[3][SKIN_BLOCK];
+};
+
+static void GatherBlock(const DualQuaternion* bones, const SkinWeights* weights,
+	const Vector3D* positions, const Vector3D* normals, int n, SkinBlock& s)
+{
+	for (int i = 0; i < n; i++)
+	{
+		for (int k = 0; k < 4; k++)
+		{
+			const DualQuaternion& d = bones[weights[i].bone[k]];
+			s.b[k][0][i] = d.real.w; s.b[k][1][i] = d.real.x; s.b[k][2][i] = d.real.y; s.b[k][3][i] = d.real.z;
+			s.b[k][4][i] = d.dual.w; s.b[k][5][i] = d.dual.x; s.b[k][6][i] = d.dual.y; s.b[k][7][i] = d.dual.z;
+			s.w[k][i] = weights[i].weight[k];
+		}
+
+		s.p[0][i] = positions[i].x; s.p[1][i] = positions[i].y; s.p[2][i] = positions[i].z;
+	}
+
+	if (normals != nullptr)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			s.n[0][i] = normals[i].x; s.n[1][i] = normals[i].y; s.n[2][i] = normals[i].z;
+		}
+	}
+}
+
+// Blends the bones of each vertex into s.r, s.scale and s.t.
+// The blend isn't normalized: for a blended real part r with squared length len2, rotating by r / |r| is
+//  v + (2 / len2)(rw (u x v) + u x (u x v)) with u the vector part of r, and the translation is
+//  (2 / len2) times the vector part of dual * Conjugate(r). So one division covers both.
+static void BlendBlock(SkinBlock& s, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		float r[8];
+		for (int c = 0; c < 8; c++)
+		{
+			r[c] = s.w[0][i] * s.b[0][c][i];
+		}
+
+		for (int k = 1; k < 4; k++)
+		{
+			// Flip bones whose rotation is in the other hemisphere from the first bone's
+			float dot = s.b[0][0][i] * s.b[k][0][i] + s.b[0][1][i] * s.b[k][1][i]
+				+ s.b[0][2][i] * s.b[k][2][i] + s.b[0][3][i] * s.b[k][3][i];
+			float w = (dot < 0) ? -s.w[k][i] : s.w[k][i];
+
+			for (int c = 0; c < 8; c++)
+			{
+				r[c] += w * s.b[k][c][i];
+			}
+		}
+
+		float rw = r[0], ux = r[1], uy = r[2], uz = r[3];
+		float dw = r[4], dx = r[5], dy = r[6], dz = r[7];
+		float scale = 2.0f / (rw * rw + ux * ux + uy * uy + uz * uz);
+
+		s.r[0][i] = rw; s.r[1][i] = ux; s.r[2][i] = uy; s.r[3][i] = uz;
+		s.scale[i] = scale;
+
+		// The vector part of dual * Conjugate(real): rw d - dw u + u x d
+		s.t[0][i] = scale * (rw * dx - dw * ux + (uy * dz - uz * dy));
+		s.t[1][i] = scale * (rw * dy - dw * uy + (uz * dx - ux * dz));
+		s.t[2][i] = scale * (rw * dz - dw * uz + (ux * dy - uy * dx));
+	}
+}
+
+// Rotates the vectors in v by the blended rotations, and with TRANSLATE translates them too.
+template <bool TRANSLATE>
+static void TransformBlock(SkinBlock& s, float v[3][SKIN_BLOCK], int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		float rw = s.r[0][i], ux = s.r[1][i], uy = s.r[2][i], uz = s.r[3][i];
+		float vx = v[0][i], vy = v[1][i], vz = v[2][i];
+
+		float cx = uy * vz - uz * vy;
+		float cy = uz * vx - ux * vz;
+		float cz = ux * vy - uy * vx;
+
+		float ex = rw * cx + (uy * cz - uz * cy);
+		float ey = rw * cy + (uz * cx - ux * cz);
+		float ez = rw * cz + (ux * cy - uy * cx);
+
+		v[0][i] = vx + s.scale[i] * ex + (TRANSLATE ? s.t[0][i] : 0.0f);
+		v[1][i] = vy + s.scale[i] * ey + (TRANSLATE ? s.t[1][i] : 0.0f);
+		v[2][i] = vz + s.scale[i] * ez + (TRANSLATE ? s.t[2][i] : 0.0f);
+	}
+}
+
+static void SkinRange(const DualQuaternion* bones, const SkinWeights* weights,
+	const Vector3D* positions, const Vector3D* normals,
+	Vector3D* outPositions, Vector3D* outNormals, int count)
+{
+	SkinBlock s;
+
+	for (int start = 0; start < count; start += SKIN_BLOCK)
+	{
+		int n = (count - start < SKIN_BLOCK) ? count - start : SKIN_BLOCK;
+		GatherBlock(bones, weights + start, positions + start, (normals != nullptr) ? normals + start : nullptr, n, s);
+		BlendBlock(s, n);
+		TransformBlock<true>(s, s.p, n);
+
+		for (int i = 0; i < n; i++)
+		{
+			outPositions[start + i] = Vector3D(s.p[0][i], s.p[1][i], s.p[2][i]);
+		}
+
+		if (normals != nullptr)
+		{
+			TransformBlock<false>(s, s.n, n);
+			for (int i = 0; i < n; i++)
+			{
+				outNormals[start + i] = Vector3D(s.n[0][i], s.n[1][i], s.n[2][i]);
+			}
+		}
+	}
+}
+
+void SkinVertices(const DualQuaternion* bones, const SkinWeights* weights,
+	const Vector3D* positions, const Vector3D* normals,
+	Vector3D* outPositions, Vector3D* outNormals, int count, int threads)
+{
+	ParallelFor(count, threads, SKIN_CHUNK, [=](int begin, int end)
+	{
+		SkinRange(bones, weights + begin, positions + begin, (normals != nullptr) ? normals + begin : nullptr,
+			outPositions + begin, (outNormals != nullptr) ? outNormals + begin : nullptr, end - begin);
+	});
+}
@@ -0,0 +1,44 @@
+/*
+Title: Quaternion Math
+File Name: Skinning.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "DualQuaternion.h"
+
+// The bones that move a vertex and how much each one counts. The weights should add up to 1;
+//  unused slots have a weight of 0 (their bone index is still read, so keep it valid, e.g. 0).
+struct SkinWeights
+{
+	unsigned short bone[4];
+	float weight[4];
+};
+
+// Dual quaternion skinning: moves count vertices by the weighted blend of up to 4 bones each.
+// bones holds the skinning transform of each bone, its current world transform times the inverse of its bind pose,
+//  as unit dual quaternions: 32 bytes a bone instead of the 64 of a Matrix4D.
+// For each vertex the bones' dual quaternions are summed with their weights, each flipped to the same hemisphere
+//  as the first so that q and -q (the same rotation) don't cancel, and the sum is normalized.
+// That blends rotations instead of matrices, so joints keep their volume where linear blend skinning collapses
+//  (the candy-wrapper effect when twisting).
+// The positions are rotated and translated and the normals (which may be nullptr) only rotated, in the same pass.
+// outPositions and outNormals may be the same arrays as positions and normals.
+// The work is split across up to threads threads (0 for one per hardware thread, see ParallelFor),
+//  though buffers under about 16K vertices always run on the calling thread.
+void SkinVertices(const DualQuaternion* bones, const SkinWeights* weights,
+	const Vector3D* positions, const Vector3D* normals,
+	Vector3D* outPositions, Vector3D* outNormals, int count, int threads = 1);
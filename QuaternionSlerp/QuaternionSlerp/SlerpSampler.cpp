@@ -0,0 +1,96 @@
+/*
+Title: Quaternion Math
+File Name: SlerpSampler.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "SlerpSampler.h"
+
+// Rotating (cosPhi, sinPhi) over and over slowly changes its length because of rounding.
+// Scaling it back to length 1 every so often keeps that drift bounded no matter how many samples are taken.
+static const int RENORMALIZE_INTERVAL = 64;
+
+SlerpSampler::SlerpSampler(Quaternion a, Quaternion b, double t0, double dt)
+	: a(a), c(), cosPhi(1), sinPhi(0), cosStep(1), sinStep(0),
+	degenerate(false), b(b), t(t0), dt(dt), sinceRenormalize(0)
+{
+	// These are the same tests as in Slerp, done in double like the rest of the sampler
+	double cosHalfTheta = (a.w * b.w) + (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+
+	if (fabs(cosHalfTheta) >= 1.0)
+	{
+		degenerate = true;
+		return;
+	}
+
+	double halfTheta = acos(cosHalfTheta);
+	double sinHalfTheta = sqrt(1.0f - cosHalfTheta * cosHalfTheta);
+
+	if (fabs(sinHalfTheta) < 0.001)
+	{
+		degenerate = true;
+		return;
+	}
+
+	c = (b - (float)cosHalfTheta * a) / (float)sinHalfTheta;
+
+	cosPhi = cos(t0 * halfTheta);
+	sinPhi = sin(t0 * halfTheta);
+	cosStep = cos(dt * halfTheta);
+	sinStep = sin(dt * halfTheta);
+}
+
+Quaternion SlerpSampler::Next()
+{
+	if (degenerate)
+	{
+		Quaternion q = Slerp(a, b, t);
+		t += dt;
+		return q;
+	}
+
+	Quaternion q = (float)cosPhi * a + (float)sinPhi * c;
+
+	// Angle addition: cos(phi + step) and sin(phi + step) from cos/sin of phi and step
+	double nextCos = cosPhi * cosStep - sinPhi * sinStep;
+	double nextSin = sinPhi * cosStep + cosPhi * sinStep;
+	cosPhi = nextCos;
+	sinPhi = nextSin;
+
+	if (++sinceRenormalize == RENORMALIZE_INTERVAL)
+	{
+		double invLength = 1.0 / sqrt(cosPhi * cosPhi + sinPhi * sinPhi);
+		cosPhi *= invLength;
+		sinPhi *= invLength;
+		sinceRenormalize = 0;
+	}
+
+	t += dt;
+	return q;
+}
+
+void SampleSlerp(Quaternion a, Quaternion b, Quaternion* out, int count)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	SlerpSampler sampler(a, b, 0.0, (count > 1) ? 1.0 / (count - 1) : 0.0);
+	for (int i = 0; i < count; i++)
+	{
+		out[i] = sampler.Next();
+	}
+}
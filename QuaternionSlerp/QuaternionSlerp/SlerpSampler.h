@@ -0,0 +1,52 @@
+/*
+Title: Quaternion Math
+File Name: SlerpSampler.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "Quaternion.h"
+
+// Samples Slerp(a, b, t) at evenly spaced values t = t0, t0 + dt, t0 + 2dt, ...
+// The angle between a and b is only calculated once, in the constructor.
+// After that each sample costs a handful of multiplies instead of an acos, a sqrt and two sins.
+struct SlerpSampler
+{
+	// Slerp(a, b, t) can be rewritten as a * cos(t * halfTheta) + c * sin(t * halfTheta),
+	//  where c = (b - a * cosHalfTheta) / sinHalfTheta.
+	// So we only need to track the pair (cos(t * halfTheta), sin(t * halfTheta)),
+	//  which moves from one sample to the next by a fixed rotation of dt * halfTheta.
+	Quaternion a, c;
+	double cosPhi, sinPhi;
+	double cosStep, sinStep;
+
+	// When a and b are (nearly) parallel or opposite Slerp has no well defined arc,
+	//  so the sampler calls Slerp directly (which needs no trig in those cases).
+	bool degenerate;
+	Quaternion b;
+	double t, dt;
+
+	// Counts samples since the last renormalization of (cosPhi, sinPhi).
+	int sinceRenormalize;
+
+	SlerpSampler(Quaternion a, Quaternion b, double t0, double dt);
+
+	// Returns Slerp(a, b, t) for the current t, then advances t by dt.
+	Quaternion Next();
+};
+
+// Fills out with Slerp(a, b, t) for count values of t evenly spaced from 0 to 1 (both included).
+void SampleSlerp(Quaternion a, Quaternion b, Quaternion* out, int count);
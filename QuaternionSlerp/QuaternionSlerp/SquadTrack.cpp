@@ -0,0 +1,162 @@
+/*
+Title: Quaternion Math
+File Name: SquadTrack.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "SquadTrack.h"
+#include "Parallel.h"
+#include "QuaternionBatch.h"
+
+#include <math.h>
+
+// Samples are interpolated in blocks of this many
+static const int SQUAD_BLOCK = 64;
+
+// Tracks per thread below which EvaluateTracks doesn't start another thread
+static const int SQUAD_CHUNK = 1024;
+
+// The log of a unit quaternion (cos(theta), sin(theta) v) is (0, theta v)
+static Quaternion Log(Quaternion q)
+{
+	float s = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z);
+	float theta = atan2f(s, q.w);
+	float k = (s > 1e-6f) ? theta / s : 1.0f;
+
+	return Quaternion(0, k * q.x, k * q.y, k * q.z);
+}
+
+// The exp of a pure quaternion (0, theta v) is (cos(theta), sin(theta) v)
+static Quaternion Exp(Quaternion q)
+{
+	float theta = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z);
+	float k = (theta > 1e-6f) ? sinf(theta) / theta : 1.0f;
+
+	return Quaternion(cosf(theta), k * q.x, k * q.y, k * q.z);
+}
+
+Quaternion Squad(Quaternion a, Quaternion b, Quaternion sa, Quaternion sb, float t) noexcept
+{
+	return Slerp(Slerp(a, b, t), Slerp(sa, sb, t), 2 * t * (1 - t));
+}
+
+SquadTrack::SquadTrack(const RotationTrack& track)
+	: times(track.times), keys(track.keys), controls(track.keys)
+{
+	for (int i = 1; i + 1 < (int)keys.size(); i++)
+	{
+		Quaternion inverse = Conjugate(keys[i]);
+		Quaternion sum = Log(inverse * keys[i + 1]) + Log(inverse * keys[i - 1]);
+
+		controls[i] = Normalize(keys[i] * Exp(-0.25f * sum));
+	}
+}
+
+Quaternion SquadTrack::Evaluate(float t) const
+{
+	TrackCursor cursor;
+	return Evaluate(t, cursor);
+}
+
+Quaternion SquadTrack::Evaluate(float t, TrackCursor& cursor) const
+{
+	int count = (int)times.size();
+	int segment = FindSegment(times.data(), count, t, cursor);
+	int next = (segment + 1 < count) ? segment + 1 : segment;
+
+	// SegmentFraction clamps to [0, 1], where Squad gives the keys themselves, which holds the ends of the track
+	float u = SegmentFraction(times.data(), count, segment, t);
+	return Squad(keys[segment], keys[next], controls[segment], controls[next], u);
+}
+
+// Scratch arrays for one block of Squads
+struct SquadBlock
+{
+	float w[6][SQUAD_BLOCK], x[6][SQUAD_BLOCK], y[6][SQUAD_BLOCK], z[6][SQUAD_BLOCK];
+	float u[SQUAD_BLOCK], h[SQUAD_BLOCK];
+
+	QuaternionSoA Get(int i) { QuaternionSoA q = { w[i], x[i], y[i], z[i] }; return q; }
+
+	// Sets sample i to interpolate between keys a and b of the track, u of the way
+	void Set(int i, const SquadTrack& track, int a, int b, float fraction)
+	{
+		Quaternion q[4] = { track.keys[a], track.keys[b], track.controls[a], track.controls[b] };
+		for (int j = 0; j < 4; j++)
+		{
+			w[j][i] = q[j].w; x[j][i] = q[j].x; y[j][i] = q[j].y; z[j][i] = q[j].z;
+		}
+		u[i] = fraction;
+	}
+
+	// Squads the first n samples into the arrays at index 4, keys in 0 and 1, controls in 2 and 3
+	QuaternionSoA Run(int n)
+	{
+		for (int i = 0; i < n; i++)
+		{
+			h[i] = 2 * u[i] * (1 - u[i]);
+		}
+
+		SlerpBatch(Get(0), Get(1), u, Get(4), n);
+		SlerpBatch(Get(2), Get(3), u, Get(5), n);
+		SlerpBatch(Get(4), Get(5), h, Get(0), n);
+		return Get(0);
+	}
+};
+
+void SquadTrack::Evaluate(const float* t, Quaternion* out, int count) const
+{
+	SquadBlock block;
+	TrackCursor cursor;
+	int keyCount = (int)keys.size();
+
+	for (int start = 0; start < count; start += SQUAD_BLOCK)
+	{
+		int n = (count - start < SQUAD_BLOCK) ? count - start : SQUAD_BLOCK;
+
+		for (int i = 0; i < n; i++)
+		{
+			int segment = FindSegment(times.data(), keyCount, t[start + i], cursor);
+			int next = (segment + 1 < keyCount) ? segment + 1 : segment;
+			block.Set(i, *this, segment, next, SegmentFraction(times.data(), keyCount, segment, t[start + i]));
+		}
+
+		FromSoA(block.Run(n), out + start, n);
+	}
+}
+
+void EvaluateTracks(const SquadTrack* tracks, TrackCursor* cursors, float t, Quaternion* out, int count, int threads)
+{
+	ParallelFor(count, threads, SQUAD_CHUNK, [=](int begin, int end)
+	{
+		SquadBlock block;
+
+		for (int start = begin; start < end; start += SQUAD_BLOCK)
+		{
+			int n = (end - start < SQUAD_BLOCK) ? end - start : SQUAD_BLOCK;
+
+			for (int i = 0; i < n; i++)
+			{
+				const SquadTrack& track = tracks[start + i];
+				int keyCount = (int)track.keys.size();
+				int segment = (cursors != nullptr) ? FindSegment(track.times.data(), keyCount, t, cursors[start + i])
+					: FindSegment(track.times.data(), keyCount, t);
+				int next = (segment + 1 < keyCount) ? segment + 1 : segment;
+				block.Set(i, track, segment, next, SegmentFraction(track.times.data(), keyCount, segment, t));
+			}
+
+			FromSoA(block.Run(n), out + start, n);
+		}
+	});
+}
@@ -0,0 +1,61 @@
+/*
+Title: Quaternion Math
+File Name: SquadTrack.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "AnimationTrack.h"
+
+#include <vector>
+
+// Spherical quadrangle interpolation between keys a and b, with the control quaternions sa and sb
+//  that shape the curve near them: Slerp(Slerp(a, b, t), Slerp(sa, sb, t), 2t(1 - t)).
+// At t = 0 and t = 1 it is a and b, and with the control quaternions of SquadTrack the curve
+//  passes through the keys without the sudden change of direction that Slerp has at every key.
+Quaternion Squad(Quaternion a, Quaternion b, Quaternion sa, Quaternion sb, float t) noexcept;
+
+// A rotation track interpolated with Squad instead of Slerp, so the rotation turns smoothly through its keys.
+// The control quaternion of each key needs a log and an exp of its neighbours, so they are all worked out
+//  once when the track is built, and each evaluation costs three Slerps.
+// Before the first key and after the last the track holds the first or last key.
+struct SquadTrack
+{
+	std::vector<float> times;
+	std::vector<Quaternion> keys;
+	std::vector<Quaternion> controls;
+
+	SquadTrack() = default;
+	// The keys must be unit quaternions, which RotationTrack::AddKey has already put on the same side as each other.
+	// control[i] = keys[i] * exp(-(log(keys[i]^-1 * keys[i + 1]) + log(keys[i]^-1 * keys[i - 1])) / 4),
+	//  and the first and last keys are their own control quaternions.
+	// This treats the keys as evenly spaced in time, as Squad usually does.
+	explicit SquadTrack(const RotationTrack& track);
+
+	// Returns the rotation at time t. The track must have at least one key.
+	Quaternion Evaluate(float t) const;
+	Quaternion Evaluate(float t, TrackCursor& cursor) const;
+
+	// Samples the track at count times: out[i] = Evaluate(t[i]).
+	// The keys are found with one cursor, so sorted times are fastest, and the three Slerps are done with SlerpBatch.
+	void Evaluate(const float* t, Quaternion* out, int count) const;
+};
+
+// Samples count tracks at the same time t: out[i] = tracks[i].Evaluate(t, cursors[i]), such as every joint of a pose.
+// cursors may be nullptr to search every track from the start.
+// The tracks are split across up to threads threads (0 for one per hardware thread, see ParallelFor),
+//  though under about a thousand tracks always run on the calling thread.
+void EvaluateTracks(const SquadTrack* tracks, TrackCursor* cursors, float t, Quaternion* out, int count, int threads = 1);
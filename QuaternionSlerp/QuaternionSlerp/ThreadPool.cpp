@@ -0,0 +1,129 @@
+/*
+Title: Quaternion Math
+File Name: ThreadPool.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads)
+	: shares((threads > 0) ? threads : ((std::thread::hardware_concurrency() > 0) ? std::thread::hardware_concurrency() : 1)),
+	body(nullptr), round(0), busy(0), stopping(false)
+{
+	workers.reserve(shares.size() - 1);
+	for (int i = 1; i < (int)shares.size(); i++)
+	{
+		workers.emplace_back([this, i]() { Work(i); });
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	start.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+}
+
+int ThreadPool::Size() const
+{
+	return (int)shares.size();
+}
+
+void ThreadPool::Run(int count, const std::function<void(int, int)>& body)
+{
+	int threads = Size();
+
+	for (int i = 0; i < threads; i++)
+	{
+		shares[i].next.store((int)((long long)count * i / threads), std::memory_order_relaxed);
+		shares[i].end = (int)((long long)count * (i + 1) / threads);
+	}
+
+	if (threads == 1)
+	{
+		this->body = &body;
+		RunItems(0);
+		return;
+	}
+
+	// The shares are written before the lock is taken, so the workers see them once they see the new round
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		this->body = &body;
+		busy = threads - 1;
+		round++;
+	}
+	start.notify_all();
+
+	RunItems(0);
+
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this]() { return busy == 0; });
+}
+
+void ThreadPool::Work(int thread)
+{
+	long long seen = 0;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			start.wait(lock, [this, seen]() { return stopping || round != seen; });
+			if (stopping)
+			{
+				return;
+			}
+			seen = round;
+		}
+
+		RunItems(thread);
+
+		bool last;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			last = (--busy == 0);
+		}
+		if (last)
+		{
+			finished.notify_one();
+		}
+	}
+}
+
+// Takes items one at a time from the thread's own share, then from each of the others in turn.
+// Taking an item is a single fetch_add, which hands every item to exactly one thread,
+//  and items past the end of a share are just ignored.
+void ThreadPool::RunItems(int thread)
+{
+	int threads = Size();
+
+	for (int k = 0; k < threads; k++)
+	{
+		Share& share = shares[(thread + k) % threads];
+
+		for (int item = share.next.fetch_add(1); item < share.end; item = share.next.fetch_add(1))
+		{
+			(*body)(item, thread);
+		}
+	}
+}
@@ -0,0 +1,75 @@
+/*
+Title: Quaternion Math
+File Name: ThreadPool.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A set of threads that are started once and then reused, for work that is run many times a frame,
+//  where starting new threads each time, as ParallelFor does, would cost tens of microseconds per call.
+// Run hands out the items by work stealing: each thread starts on its own contiguous share of the items,
+//  and once that is used up it takes the items left in the other threads' shares,
+//  so threads that get quick items help out with the slow ones instead of waiting.
+class ThreadPool
+{
+public:
+	// Starts threads - 1 threads (0 for one per hardware thread), since the thread calling Run is the other one.
+	explicit ThreadPool(int threads = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// The number of threads that run items, including the calling thread
+	int Size() const;
+
+	// Calls body(item, thread) once for every item in [0, count), and returns when all of them are done.
+	// thread is in [0, Size()) and no two calls with the same thread run at once,
+	//  so it can index scratch memory kept for each thread.
+	// body must not throw, and only one thread may call Run at a time.
+	void Run(int count, const std::function<void(int, int)>& body);
+
+private:
+	// The items [next, end) not yet taken from one thread's share, padded so that each one is on its own cache line
+	struct Share
+	{
+		std::atomic<int> next;
+		int end;
+		char padding[64 - sizeof(std::atomic<int>) - sizeof(int)];
+	};
+
+	void Work(int thread);
+	void RunItems(int thread);
+
+	std::vector<std::thread> workers;
+	std::vector<Share> shares;
+	const std::function<void(int, int)>* body;
+
+	std::mutex mutex;
+	std::condition_variable start;
+	std::condition_variable finished;
+	// Run adds one to round to start the workers, and each one takes one off busy when it is done
+	long long round;
+	int busy;
+	bool stopping;
+};
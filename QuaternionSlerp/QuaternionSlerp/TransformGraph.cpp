@@ -0,0 +1,132 @@
+/*
+Title: Quaternion Math
+File Name: TransformGraph.cpp
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "TransformGraph.h"
+
+TransformGraph::TransformGraph()
+	: recomputed(0), skipped(0)
+{
+}
+
+int TransformGraph::AddNode(int parent, const Matrix4D& m)
+{
+	int node = (int)parents.size();
+
+	parents.push_back(parent);
+	children.emplace_back();
+	local.push_back(m);
+	world.emplace_back();
+	dirty.push_back(1);
+
+	if (parent >= 0)
+	{
+		children[parent].push_back(node);
+	}
+
+	return node;
+}
+
+void TransformGraph::SetLocal(int node, const Matrix4D& m)
+{
+	local[node] = m;
+	MarkDirty(node);
+}
+
+void TransformGraph::SetLocal(int node, Quaternion rotation, Vector3D translation, float scale)
+{
+	Matrix3D r = RotationMatrix(rotation);
+
+	SetLocal(node, Matrix4D(scale * r(0, 0), scale * r(0, 1), scale * r(0, 2), translation.x,
+		scale * r(1, 0), scale * r(1, 1), scale * r(1, 2), translation.y,
+		scale * r(2, 0), scale * r(2, 1), scale * r(2, 2), translation.z,
+		0, 0, 0, 1));
+}
+
+// Goes up from the node while the ancestors are dirty, then recomputes back down,
+//  so that each parent is up to date before its child.
+const Matrix4D& TransformGraph::World(int node)
+{
+	if (!dirty[node])
+	{
+		skipped++;
+		return world[node];
+	}
+
+	pending.clear();
+	for (int i = node; i >= 0 && dirty[i]; i = parents[i])
+	{
+		pending.push_back(i);
+	}
+
+	for (int k = (int)pending.size() - 1; k >= 0; k--)
+	{
+		Recompute(pending[k]);
+	}
+
+	return world[node];
+}
+
+// Parents have lower indices than their children, so going through the nodes in order
+//  always reaches a parent first.
+void TransformGraph::Update()
+{
+	for (int i = 0; i < (int)parents.size(); i++)
+	{
+		if (dirty[i])
+		{
+			Recompute(i);
+		}
+		else
+		{
+			skipped++;
+		}
+	}
+}
+
+void TransformGraph::ResetCounters()
+{
+	recomputed = 0;
+	skipped = 0;
+}
+
+// The descendants of a node that is already dirty are dirty too, so the search doesn't go below one.
+void TransformGraph::MarkDirty(int node)
+{
+	pending.clear();
+	pending.push_back(node);
+
+	while (!pending.empty())
+	{
+		int i = pending.back();
+		pending.pop_back();
+
+		if (!dirty[i])
+		{
+			dirty[i] = 1;
+			pending.insert(pending.end(), children[i].begin(), children[i].end());
+		}
+	}
+}
+
+void TransformGraph::Recompute(int node)
+{
+	int parent = parents[node];
+	world[node] = (parent < 0) ? local[node] : world[parent] * local[node];
+	dirty[node] = 0;
+	recomputed++;
+}
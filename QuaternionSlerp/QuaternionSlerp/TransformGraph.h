@@ -0,0 +1,69 @@
+/*
+Title: Quaternion Math
+File Name: TransformGraph.h
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#pragma once
+
+#include "Matrix4D.h"
+#include "Quaternion.h"
+
+#include <vector>
+
+// A hierarchy of nodes, each with a local transform relative to its parent, that keeps every node's world transform
+//  (world[parent] * local) cached and only recomputes the ones that have changed.
+// Changing a node's local transform marks it and all of its descendants dirty. A dirty node's world transform is
+//  recomputed the next time it is asked for, or by Update, which brings every node up to date.
+// A dirty node always has only dirty descendants, so marking can stop at a node that is already dirty,
+//  and moving the same node every frame costs no more than moving it once.
+struct TransformGraph
+{
+	// parents[i] is the parent of node i, which is less than i, or -1 if node i is a root
+	std::vector<int> parents;
+	std::vector<std::vector<int>> children;
+	std::vector<Matrix4D> local;
+	std::vector<Matrix4D> world;
+	std::vector<unsigned char> dirty;
+
+	// How many world transforms have been recomputed, and how many were found up to date and skipped,
+	//  by World and Update since the graph was made or the counters were last reset.
+	long long recomputed;
+	long long skipped;
+
+	// Nodes waiting to be marked dirty or recomputed, kept here so that it doesn't have to be allocated each time
+	std::vector<int> pending;
+
+	TransformGraph();
+
+	// Adds a node under parent (-1 for a new root), which must already be in the graph, and returns its index.
+	int AddNode(int parent, const Matrix4D& m);
+
+	// Changes a node's local transform to m, or to scale, then rotate by rotation (a unit quaternion), then translate.
+	void SetLocal(int node, const Matrix4D& m);
+	void SetLocal(int node, Quaternion rotation, Vector3D translation, float scale = 1);
+
+	// Returns the node's world transform, first recomputing it and any dirty ancestors if needed.
+	const Matrix4D& World(int node);
+
+	// Recomputes the world transform of every dirty node, in one pass from the roots down.
+	void Update();
+
+	void ResetCounters();
+
+private:
+	void MarkDirty(int node);
+	void Recompute(int node);
+};
@@ -20,98 +20,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "Vector2D.h"
 
-Vector2D::Vector2D()
-	: x(0), y(0)
-{
-}
-
-Vector2D::Vector2D(float x, float y)
-	: x(x), y(y)
-{
-}
-
-Vector2D operator-(Vector2D v)
-{
-	return Vector2D(-v.x, -v.y);
-}
-
-Vector2D operator+(Vector2D l, Vector2D r)
-{
-	return Vector2D(l.x + r.x, l.y + r.y);
-}
-
-Vector2D operator-(Vector2D l, Vector2D r)
-{
-	return l + (-r);
-}
-
-Vector2D operator*(float s, Vector2D v)
-{
-	return Vector2D(s * v.x, s * v.y);
-}
-
-Vector2D operator*(Vector2D v, float s)
-{
-	return s * v;
-}
-
-Vector2D operator/(Vector2D v, float s)
-{
-	return (1.0f / s) * v;
-}
-
-bool operator==(Vector2D l, Vector2D r)
-{
-	return ((l.x == r.x) && (l.y == r.y));
-}
-
-bool operator!=(Vector2D l, Vector2D r)
-{
-	return !(l == r);
-}
-
-float Dot(Vector2D l, Vector2D r)
-{
-	return l.x * r.x + l.y * r.y;
-}
-
-Vector2D Project(Vector2D a, Vector2D b)
-{
-	return  (Dot(a, b) / Dot(b, b)) * b;
-}
-
-Vector2D Reject(Vector2D a, Vector2D b)
-{
-	return a - Project(a, b);
-}
-
-Vector2D Normalize(Vector2D v)
-{
-	return v / Magnitude(v);
-}
-
-float Magnitude(Vector2D v)
-{
-	return sqrtf(Dot(v, v));
-}
-
-float MagInverse(Vector2D v)
-{
-	return 1.0f / Magnitude(v);
-}
-
-float MagFastInv(Vector2D v)
-{
-	return FastInvSqrt(Dot(v, v));
-}
-
-float MagSquared(Vector2D v)
-{
-	return Dot(v, v);
-}
-
-std::ostream& operator<<(std::ostream& os, Vector2D v)
-{
-	os << "(" << v.x << ", " << v.y << ")";
-	return os;
-}
+#ifndef MATH_HEADER_ONLY
+#include "Vector2D.inl"
+#endif
@@ -29,30 +29,106 @@ struct Vector2D
 {
 	float x, y;
 
-	Vector2D();
+	constexpr Vector2D() noexcept;
 
-	Vector2D(float x, float y);
+	constexpr Vector2D(float x, float y) noexcept;
 };
 
-Vector2D operator-(Vector2D v);
-Vector2D operator+(Vector2D l, Vector2D r);
-Vector2D operator-(Vector2D l, Vector2D r);
-Vector2D operator*(float s, Vector2D v);
-Vector2D operator*(Vector2D v, float s);
-Vector2D operator/(Vector2D v, float s);
+constexpr Vector2D operator-(Vector2D v) noexcept;
+constexpr Vector2D operator+(Vector2D l, Vector2D r) noexcept;
+constexpr Vector2D operator-(Vector2D l, Vector2D r) noexcept;
+constexpr Vector2D operator*(float s, Vector2D v) noexcept;
+constexpr Vector2D operator*(Vector2D v, float s) noexcept;
+constexpr Vector2D operator/(Vector2D v, float s) noexcept;
 
-bool operator==(Vector2D l, Vector2D r);
-bool operator!=(Vector2D l, Vector2D r);
+constexpr bool operator==(Vector2D l, Vector2D r) noexcept;
+constexpr bool operator!=(Vector2D l, Vector2D r) noexcept;
 
-float Dot(Vector2D l, Vector2D r);
-Vector2D Project(Vector2D a, Vector2D b);
-Vector2D Reject(Vector2D a, Vector2D b);
+constexpr float Dot(Vector2D l, Vector2D r) noexcept;
+constexpr Vector2D Project(Vector2D a, Vector2D b) noexcept;
+constexpr Vector2D Reject(Vector2D a, Vector2D b) noexcept;
 
-Vector2D Normalize(Vector2D v);
+Vector2D Normalize(Vector2D v) noexcept;
 
-float Magnitude(Vector2D v);
-float MagInverse(Vector2D v);
-float MagFastInv(Vector2D v);
-float MagSquared(Vector2D v);
+float Magnitude(Vector2D v) noexcept;
+float MagInverse(Vector2D v) noexcept;
+float MagFastInv(Vector2D v) noexcept;
+constexpr float MagSquared(Vector2D v) noexcept;
 
 std::ostream& operator<<(std::ostream& os, Vector2D v);
+
+// The constexpr functions are defined here so that they can be evaluated at compile time.
+
+constexpr Vector2D::Vector2D() noexcept
+	: x(0), y(0)
+{
+}
+
+constexpr Vector2D::Vector2D(float x, float y) noexcept
+	: x(x), y(y)
+{
+}
+
+constexpr Vector2D operator-(Vector2D v) noexcept
+{
+	return Vector2D(-v.x, -v.y);
+}
+
+constexpr Vector2D operator+(Vector2D l, Vector2D r) noexcept
+{
+	return Vector2D(l.x + r.x, l.y + r.y);
+}
+
+constexpr Vector2D operator-(Vector2D l, Vector2D r) noexcept
+{
+	return l + (-r);
+}
+
+constexpr Vector2D operator*(float s, Vector2D v) noexcept
+{
+	return Vector2D(s * v.x, s * v.y);
+}
+
+constexpr Vector2D operator*(Vector2D v, float s) noexcept
+{
+	return s * v;
+}
+
+constexpr Vector2D operator/(Vector2D v, float s) noexcept
+{
+	return (1.0f / s) * v;
+}
+
+constexpr bool operator==(Vector2D l, Vector2D r) noexcept
+{
+	return ((l.x == r.x) && (l.y == r.y));
+}
+
+constexpr bool operator!=(Vector2D l, Vector2D r) noexcept
+{
+	return !(l == r);
+}
+
+constexpr float Dot(Vector2D l, Vector2D r) noexcept
+{
+	return l.x * r.x + l.y * r.y;
+}
+
+constexpr Vector2D Project(Vector2D a, Vector2D b) noexcept
+{
+	return  (Dot(a, b) / Dot(b, b)) * b;
+}
+
+constexpr Vector2D Reject(Vector2D a, Vector2D b) noexcept
+{
+	return a - Project(a, b);
+}
+
+constexpr float MagSquared(Vector2D v) noexcept
+{
+	return Dot(v, v);
+}
+
+#ifdef MATH_HEADER_ONLY
+#include "Vector2D.inl"
+#endif
@@ -29,38 +29,126 @@ struct Vector3D
 {
 	float x, y, z;
 
-	Vector3D();
-	Vector3D(float x, float y, float z);
+	constexpr Vector3D() noexcept;
+	constexpr Vector3D(float x, float y, float z) noexcept;
 };
 
-Vector3D operator-(Vector3D v);
+constexpr Vector3D operator-(Vector3D v) noexcept;
 
-Vector3D operator+(Vector3D l, Vector3D r);
-Vector3D operator-(Vector3D l, Vector3D r);
+constexpr Vector3D operator+(Vector3D l, Vector3D r) noexcept;
+constexpr Vector3D operator-(Vector3D l, Vector3D r) noexcept;
 
-Vector3D operator*(float s, Vector3D v);
-Vector3D operator*(Vector3D v, float s);
-Vector3D operator/(Vector3D v, float s);
+constexpr Vector3D operator*(float s, Vector3D v) noexcept;
+constexpr Vector3D operator*(Vector3D v, float s) noexcept;
+constexpr Vector3D operator/(Vector3D v, float s) noexcept;
 
-bool operator==(Vector3D l, Vector3D r);
-bool operator!=(Vector3D l, Vector3D r);
+constexpr bool operator==(Vector3D l, Vector3D r) noexcept;
+constexpr bool operator!=(Vector3D l, Vector3D r) noexcept;
 
-float Dot(Vector3D l, Vector3D r);
+constexpr float Dot(Vector3D l, Vector3D r) noexcept;
 
-Vector3D Project(Vector3D a, Vector3D b);
-Vector3D Reject(Vector3D a, Vector3D b);
+constexpr Vector3D Project(Vector3D a, Vector3D b) noexcept;
+constexpr Vector3D Reject(Vector3D a, Vector3D b) noexcept;
 
-Vector3D Normalize(Vector3D v);
+Vector3D Normalize(Vector3D v) noexcept;
 
 // Calculates the cross product of a and b according to the right-hand rule.
-Vector3D Cross(Vector3D a, Vector3D b);
+constexpr Vector3D Cross(Vector3D a, Vector3D b) noexcept;
 
-float Magnitude(Vector3D v);
-float MagInverse(Vector3D v);
-float MagFastInv(Vector3D v);
-float MagSquared(Vector3D v);
+float Magnitude(Vector3D v) noexcept;
+float MagInverse(Vector3D v) noexcept;
+float MagFastInv(Vector3D v) noexcept;
+constexpr float MagSquared(Vector3D v) noexcept;
 
 // Calculates the volume of the parallelepiped defined by a, b, and c.
-float ScalarTriple(Vector3D a, Vector3D b, Vector3D c);
+constexpr float ScalarTriple(Vector3D a, Vector3D b, Vector3D c) noexcept;
 
 std::ostream& operator<<(std::ostream& os, Vector3D v);
+
+// The constexpr functions are defined here so that they can be evaluated at compile time.
+
+constexpr Vector3D::Vector3D() noexcept
+	: x(0), y(0), z(0)
+{
+}
+
+constexpr Vector3D::Vector3D(float x, float y, float z) noexcept
+	: x(x), y(y), z(z)
+{
+}
+
+constexpr Vector3D operator-(Vector3D v) noexcept
+{
+	return Vector3D(-v.x, -v.y, -v.z);
+}
+
+constexpr Vector3D operator+(Vector3D l, Vector3D r) noexcept
+{
+	return Vector3D(l.x + r.x, l.y + r.y, l.z + r.z);
+}
+
+constexpr Vector3D operator-(Vector3D l, Vector3D r) noexcept
+{
+	return l + (-r);
+}
+
+constexpr Vector3D operator*(float s, Vector3D v) noexcept
+{
+	return Vector3D(s * v.x, s * v.y, s * v.z);
+}
+
+constexpr Vector3D operator*(Vector3D v, float s) noexcept
+{
+	return s * v;
+}
+
+constexpr Vector3D operator/(Vector3D v, float s) noexcept
+{
+	return (1.0f / s) * v;
+}
+
+constexpr bool operator==(Vector3D l, Vector3D r) noexcept
+{
+	return ((l.x == r.x) && (l.y == r.y) && (l.z == r.z));
+}
+
+constexpr bool operator!=(Vector3D l, Vector3D r) noexcept
+{
+	return !(l == r);
+}
+
+constexpr float Dot(Vector3D l, Vector3D r) noexcept
+{
+	return l.x * r.x + l.y * r.y + l.z * r.z;
+}
+
+constexpr Vector3D Project(Vector3D a, Vector3D b) noexcept
+{
+	return (Dot(a, b) / Dot(b, b)) * b;
+}
+
+constexpr Vector3D Reject(Vector3D a, Vector3D b) noexcept
+{
+	return a - Project(a, b);
+}
+
+constexpr Vector3D Cross(Vector3D a, Vector3D b) noexcept
+{
+	return Vector3D(a.y * b.z - a.z * b.y,
+		a.z * b.x - a.x * b.z,
+		a.x * b.y - a.y * b.x);
+}
+
+constexpr float MagSquared(Vector3D v) noexcept
+{
+	return Dot(v, v);
+}
+
+constexpr float ScalarTriple(Vector3D a, Vector3D b, Vector3D c) noexcept
+{
+	return Dot(Cross(a, b), c);
+}
+
+#ifdef MATH_HEADER_ONLY
+#include "Vector3D.inl"
+#endif
@@ -0,0 +1,48 @@
+/*
+Title: Vector Mathematics
+File Name: Vector3D.inl
+Copyright  2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Definitions of the functions declared in Vector3D.h (see MATH_HEADER_ONLY in helpers.h).
+#pragma once
+
+MATH_INLINE Vector3D Normalize(Vector3D v) noexcept
+{
+	return v / Magnitude(v);
+}
+
+MATH_INLINE float Magnitude(Vector3D v) noexcept
+{
+	return sqrtf(Dot(v, v));
+}
+
+MATH_INLINE float MagInverse(Vector3D v) noexcept
+{
+	return 1.0f / Magnitude(v);
+}
+
+MATH_INLINE float MagFastInv(Vector3D v) noexcept
+{
+	return FastInvSqrt(Dot(v, v));
+}
+
+MATH_INLINE std::ostream& operator<<(std::ostream& os, Vector3D v)
+{
+	os << "(" << v.x << ", " << v.y << ", " << v.z << ")";
+	return os;
+}
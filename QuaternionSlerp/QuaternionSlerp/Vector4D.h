@@ -30,39 +30,120 @@ struct Vector4D
 {
 	float x, y, z, w;
 
-	Vector4D();
-	Vector4D(float x, float y, float z, float w);
+	constexpr Vector4D() noexcept;
+	constexpr Vector4D(float x, float y, float z, float w) noexcept;
 
 	// This is a new constructor that is able to `inject' a 3D vector into 4D space.
-	Vector4D(Vector3D v, float w);
+	constexpr Vector4D(Vector3D v, float w) noexcept;
 };
 
-Vector4D operator-(Vector4D v);
+constexpr Vector4D operator-(Vector4D v) noexcept;
 
-Vector4D operator+(Vector4D l, Vector4D r);
-Vector4D operator-(Vector4D l, Vector4D r);
+constexpr Vector4D operator+(Vector4D l, Vector4D r) noexcept;
+constexpr Vector4D operator-(Vector4D l, Vector4D r) noexcept;
 
-Vector4D operator*(float s, Vector4D v);
-Vector4D operator*(Vector4D v, float s);
-Vector4D operator/(Vector4D v, float s);
+constexpr Vector4D operator*(float s, Vector4D v) noexcept;
+constexpr Vector4D operator*(Vector4D v, float s) noexcept;
+constexpr Vector4D operator/(Vector4D v, float s) noexcept;
 
-bool operator==(Vector4D l, Vector4D r);
-bool operator!=(Vector4D l, Vector4D r);
+constexpr bool operator==(Vector4D l, Vector4D r) noexcept;
+constexpr bool operator!=(Vector4D l, Vector4D r) noexcept;
 
-float Dot(Vector4D l, Vector4D r);
+constexpr float Dot(Vector4D l, Vector4D r) noexcept;
 
-Vector4D Project(Vector4D a, Vector4D b);
-Vector4D Reject(Vector4D a, Vector4D b);
+constexpr Vector4D Project(Vector4D a, Vector4D b) noexcept;
+constexpr Vector4D Reject(Vector4D a, Vector4D b) noexcept;
 
-Vector4D Normalize(Vector4D v);
+Vector4D Normalize(Vector4D v) noexcept;
 
 // Divides v by its w component or adds 1 to the w component, such that the final w component is 1.
 // In this way, it becomes a homogeneous point.
-Vector4D Pointify(Vector4D v);
+Vector4D Pointify(Vector4D v) noexcept;
 
-float Magnitude(Vector4D v);
-float MagInverse(Vector4D v);
-float MagFastInv(Vector4D v);
-float MagSquared(Vector4D v);
+float Magnitude(Vector4D v) noexcept;
+float MagInverse(Vector4D v) noexcept;
+float MagFastInv(Vector4D v) noexcept;
+constexpr float MagSquared(Vector4D v) noexcept;
 
 std::ostream& operator<<(std::ostream& os, Vector4D v);
+
+// The constexpr functions are defined here so that they can be evaluated at compile time.
+
+constexpr Vector4D::Vector4D() noexcept
+	: x(0), y(0), z(0), w(0)
+{
+}
+
+constexpr Vector4D::Vector4D(float x, float y, float z, float w) noexcept
+	: x(x), y(y), z(z), w(w)
+{
+}
+
+constexpr Vector4D::Vector4D(Vector3D v, float w) noexcept
+	: x(v.x), y(v.y), z(v.z), w(w)
+{
+}
+
+constexpr Vector4D operator-(Vector4D v) noexcept
+{
+	return Vector4D(-v.x, -v.y, -v.z, -v.w);
+}
+
+constexpr Vector4D operator+(Vector4D l, Vector4D r) noexcept
+{
+	return Vector4D(l.x + r.x, l.y + r.y, l.z + r.z, l.w + r.w);
+}
+
+constexpr Vector4D operator-(Vector4D l, Vector4D r) noexcept
+{
+	return l + (-r);
+}
+
+constexpr Vector4D operator*(float s, Vector4D v) noexcept
+{
+	return Vector4D(s * v.x, s * v.y, s * v.z, s * v.w);
+}
+
+constexpr Vector4D operator*(Vector4D v, float s) noexcept
+{
+	return s * v;
+}
+
+constexpr Vector4D operator/(Vector4D v, float s) noexcept
+{
+	return (1.0f / s) * v;
+}
+
+constexpr bool operator==(Vector4D l, Vector4D r) noexcept
+{
+	return ((l.x == r.x) && (l.y == r.y) && (l.z == r.z) && (l.w == r.w));
+}
+
+constexpr bool operator!=(Vector4D l, Vector4D r) noexcept
+{
+	return !(l == r);
+}
+
+constexpr float Dot(Vector4D l, Vector4D r) noexcept
+{
+	return l.x * r.x + l.y * r.y + l.z * r.z + l.w * r.w;
+}
+
+constexpr Vector4D Project(Vector4D a, Vector4D b) noexcept
+{
+	return (Dot(a, b) / Dot(b, b)) * b;
+}
+
+constexpr Vector4D Reject(Vector4D a, Vector4D b) noexcept
+{
+	return a - Project(a, b);
+}
+
+constexpr float MagSquared(Vector4D v) noexcept
+{
+	return Dot(v, v);
+}
+
+#ifdef MATH_HEADER_ONLY
+#include "Vector4D.inl"
+#endif
@@ -0,0 +1,53 @@
+/*
+Title: Vector Mathematics
+File Name: Vector4D.inl
+Copyright  2016
+Author: Andrew Litfin
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+// Definitions of the functions declared in Vector4D.h (see MATH_HEADER_ONLY in helpers.h).
+#pragma once
+
+MATH_INLINE Vector4D Normalize(Vector4D v) noexcept
+{
+	return v / Magnitude(v);
+}
+
+MATH_INLINE Vector4D Pointify(Vector4D v) noexcept
+{
+	return (v.w == 0) ? v + Vector4D(0, 0, 0, 1) : v / v.w;
+}
+
+MATH_INLINE float Magnitude(Vector4D v) noexcept
+{
+	return sqrtf(Dot(v, v));
+}
+
+MATH_INLINE float MagInverse(Vector4D v) noexcept
+{
+	return 1.0f / Magnitude(v);
+}
+
+MATH_INLINE float MagFastInv(Vector4D v) noexcept
+{
+	return FastInvSqrt(Dot(v, v));
+}
+
+MATH_INLINE std::ostream & operator<<(std::ostream& os, Vector4D v)
+{
+	os << "(" << v.x << ", " << v.y << ", " << v.z << ", " << v.w << ")";
+	return os;
+}
@@ -20,44 +20,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include "helpers.h"
 
-float FastInvSqrt(float x)
-{
-	// Code taken from Quake III Arena, public domain
-
-	// This code is a great bit of history and trivia in the games industry.
-	// It was originally attributed to John Carmack and id Software, but it apparently goes further back than that.
-
-	// This is a great example of how black-majick-y C++ can get.
-	// See [the Wikipedia article](https://en.wikipedia.org/wiki/Fast_inverse_square_root) for an explanation.
-
-	long i;
-	float x2, y;
-	const float threehalfs = 1.5F;
-
-	x2 = x * 0.5F;
-	y = x;
-	i = *(long *)&y;						// evil floating point bit level hacking
-	i = 0x5f3759df - (i >> 1);				// what
-	y = *(float *)&i;
-	y = y * (threehalfs - (x2 * y * y));	// 1st iteration
-											//	y = y * (threehalfs - (x2 * y * y));	// 2nd iteration, this can be removed
-
-	return y;
-}
-
-// Returns a random real number in the interval [min, max] (inclusive on both ends)
-float randFloat(float min, float max)
-{
-	return min + (((float)rand()) / ((float)RAND_MAX)) * (max - min);
-}
-
-// Returns a random integer in the range { min, ..., max } (inclusive on both ends)
-int randInt(int min, int max)
-{
-	return min + (rand() % (max - min + 1));
-}
-
-float randIntF(int min, int max)
-{
-	return (float)randInt(min, max);
-}
+#ifndef MATH_HEADER_ONLY
+#include "helpers.inl"
+#endif
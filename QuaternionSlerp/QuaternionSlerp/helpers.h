@@ -20,18 +20,92 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #pragma once
 
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
+
+// The math types can be built in two ways.
+// By default each X.cpp compiles the definitions in X.inl once, and other files call them as ordinary functions.
+// Defining MATH_HEADER_ONLY (the MATH_HEADER_ONLY option in CMakeLists.txt) instead includes each X.inl from X.h,
+//  so the compiler can inline the math into its callers.
+// Either way, the constexpr functions are defined in the headers themselves, because the compiler
+//  needs their bodies to evaluate them at compile time.
+#ifdef MATH_HEADER_ONLY
+#define MATH_INLINE inline
+#else
+#define MATH_INLINE
+#endif
 
 // Approximates 1/sqrt(x) to within >99% accuracy.
 // Useful for quickly normalizing vectors.
-float FastInvSqrt(float x);
+float FastInvSqrt(float x) noexcept;
 
 // Returns a random real number in the interval [min, max)
-float randFloat(float min, float max);
+float randFloat(float min, float max) noexcept;
 
 // Returns a random integer in the range { min, ..., max }
 // N.B. min cannot be INT_MIN, causes divide by 0 error
-int randInt(int min, int max);
+int randInt(int min, int max) noexcept;
 
 // Returns a random integer in the range { min, ..., max } casted to a float
-float randIntF(int min, int max);
+float randIntF(int min, int max) noexcept;
+
+// sqrt, sin and cos that can be evaluated at compile time, for building constant tables of rotations.
+// The standard library versions are not constexpr, so these work in double with plain loops:
+//  Newton's method for sqrt, and the Taylor series for sin and cos after reducing x to [-pi, pi].
+// Their error is around 1e-15, far below float precision, so the results round to the same float as
+//  sqrtf, sinf and cosf in nearly every case. They are much slower though, so only use them for constants.
+constexpr double ConstexprSqrt(double x) noexcept;
+constexpr double ConstexprSin(double x) noexcept;
+constexpr double ConstexprCos(double x) noexcept;
+
+constexpr double ConstexprSqrt(double x) noexcept
+{
+	if (!(x > 0))
+	{
+		return 0;
+	}
+
+	// Starting above the root, every step moves down towards it, until rounding stops the progress
+	double y = (x > 1) ? x : 1;
+	double next = 0.5 * (y + x / y);
+	while (next < y)
+	{
+		y = next;
+		next = 0.5 * (y + x / y);
+	}
+
+	return y;
+}
+
+constexpr double ConstexprSin(double x) noexcept
+{
+	const double pi = 3.14159265358979323846;
+
+	// Subtract the nearest multiple of 2 pi
+	double turns = x / (2 * pi);
+	long long k = (long long)(turns < 0 ? turns - 0.5 : turns + 0.5);
+	x -= k * (2 * pi);
+
+	// x - x^3/3! + x^5/5! - ..., each term is the previous one times -x^2 / ((2i)(2i + 1))
+	double term = x;
+	double sum = x;
+	for (int i = 1; i < 20; i++)
+	{
+		term *= -x * x / ((2 * i) * (2 * i + 1));
+		sum += term;
+	}
+
+	return sum;
+}
+
+constexpr double ConstexprCos(double x) noexcept
+{
+	const double pi = 3.14159265358979323846;
+
+	return ConstexprSin(x + pi / 2);
+}
+
+#ifdef MATH_HEADER_ONLY
+#include "helpers.inl"
+#endif
@@ -21,10 +21,82 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 // The primary objective is to study the operations of Quaternions
 #include "Quaternion.h"
+#include "QuaternionStream.h"
+#include <cstdio>
+#include <cstring>
 #include <iostream>
 
-int main()
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+// QuaternionSlerp stream [--binary] [input [output]]
+// Processes a stream of records instead of showing the demo (see QuaternionStream.h). "-" stands for standard input or output.
+static int RunStream(int argc, char* argv[])
+{
+	StreamFormat format = StreamFormat::Text;
+	const char* paths[2] = { "-", "-" };
+	int pathCount = 0;
+
+	for (int i = 2; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--binary") == 0)
+		{
+			format = StreamFormat::Binary;
+		}
+		else if (pathCount < 2)
+		{
+			paths[pathCount++] = argv[i];
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s stream [--binary] [input [output]]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	const char* readMode = (format == StreamFormat::Binary) ? "rb" : "r";
+	const char* writeMode = (format == StreamFormat::Binary) ? "wb" : "w";
+	FILE* in = (strcmp(paths[0], "-") == 0) ? stdin : fopen(paths[0], readMode);
+	FILE* out = (strcmp(paths[1], "-") == 0) ? stdout : fopen(paths[1], writeMode);
+
+	if (in == nullptr || out == nullptr)
+	{
+		fprintf(stderr, "can't open %s\n", (in == nullptr) ? paths[0] : paths[1]);
+		return 1;
+	}
+
+#ifdef _WIN32
+	// Standard input and output translate line endings unless they are switched to binary
+	if (format == StreamFormat::Binary)
+	{
+		_setmode(_fileno(stdin), _O_BINARY);
+		_setmode(_fileno(stdout), _O_BINARY);
+	}
+#endif
+
+	bool processed = ProcessStream(in, out, format);
+
+	if (in != stdin)
+	{
+		fclose(in);
+	}
+	if (out != stdout && fclose(out) != 0)
+	{
+		processed = false;
+	}
+
+	return processed ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
 {
+	if (argc > 1 && strcmp(argv[1], "stream") == 0)
+	{
+		return RunStream(argc, argv);
+	}
+
 	// The general for the quaternion expression is
 	// q = w + xi + yj + zk, where w, x, y, z are real numbers
 	// and i, j, k are imaginary numbers
@@ -73,7 +145,7 @@ int main()
 	Quaternion rotationQuaternion = Rotation(Vector3D(0, 0, 1), 3.14 / 2);
 	std::cout << rotationQuaternion << std::endl;
 
-	std::cout << "Rotate the Vector using rotation matrix: " << std::endl;
+	std::cout << "Rotate the Vector using the rotation quaternion: " << std::endl;
 	Vector3D vectorToRotate = Vector3D(1, 1, 1);
 	Vector3D rotatedVector = RotateVector(vectorToRotate, rotationQuaternion);
 	std::cout << "The rotated Vector is: " << std::endl;